@@ -0,0 +1,127 @@
+#include <cstring>
+#include "../include/analytics/perf_counters.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+double PerfCounterSample::ipc() const {
+    if (!has(Cycles) || !has(Instructions) || values[Cycles] == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(values[Instructions]) / values[Cycles];
+}
+
+const char* PerfCounterSample::counterName(Counter counter) {
+    switch (counter) {
+        case Cycles: return "cycles";
+        case Instructions: return "instructions";
+        case BranchMisses: return "branchMisses";
+        case L1DMisses: return "l1dMisses";
+        case LLCMisses: return "llcMisses";
+        default: return "unknown";
+    }
+}
+
+#if defined(__linux__)
+
+// Helper function to open one counting event for the calling thread
+static int openCounter(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;        // Include worker threads spawned while counting
+    attr.exclude_kernel = 1; // Allowed at the default perf_event_paranoid level
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+PerfCounterGroup::PerfCounterGroup() {
+    const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    fds_[PerfCounterSample::Cycles] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    int firstError = fds_[PerfCounterSample::Cycles] < 0 ? errno : 0;
+    fds_[PerfCounterSample::Instructions] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[PerfCounterSample::BranchMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds_[PerfCounterSample::L1DMisses] = openCounter(PERF_TYPE_HW_CACHE, l1dReadMiss);
+    fds_[PerfCounterSample::LLCMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            available_ = true;
+        }
+    }
+    if (!available_) {
+        unavailableReason_ = std::string("perf_event_open failed: ") + std::strerror(firstError);
+    }
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void PerfCounterGroup::start() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+PerfCounterSample PerfCounterGroup::stop() {
+    PerfCounterSample sample;
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (int c = 0; c < PerfCounterSample::CounterCount; ++c) {
+        if (fds_[c] < 0) {
+            continue;
+        }
+        // value, time enabled, time running
+        uint64_t data[3] = {};
+        if (read(fds_[c], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+            continue;
+        }
+        // Scale up if the kernel multiplexed the counter with others
+        double scale = data[2] < data[1] ? static_cast<double>(data[1]) / data[2] : 1.0;
+        sample.values[c] = static_cast<uint64_t>(data[0] * scale);
+        sample.present[c] = true;
+        sample.valid = true;
+    }
+    return sample;
+}
+
+#else
+
+PerfCounterGroup::PerfCounterGroup() {
+    for (int& fd : fds_) {
+        fd = -1;
+    }
+    unavailableReason_ = "hardware counters are only supported on Linux";
+}
+
+PerfCounterGroup::~PerfCounterGroup() {}
+
+void PerfCounterGroup::start() {}
+
+PerfCounterSample PerfCounterGroup::stop() {
+    return PerfCounterSample();
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include "../include/analytics/quality_metrics.h"
+#include "../include/analytics/trace.h"
+
+// Helper function to turn a mean squared error into PSNR for 8-bit samples
+static double psnrFromMSE(double mse) {
+    if (mse <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return 10.0 * std::log10((255.0 * 255.0) / mse);
+}
+
+// Function to compare an RGBA image with its decoded counterpart
+QualityMetrics computeQualityMetrics(const ImageView& original, const uint8_t* decoded) {
+    TRACE_SCOPE("computeQualityMetrics");
+    QualityMetrics metrics;
+
+    size_t pixelCount = original.empty() ? 0 : static_cast<size_t>(original.width) * original.height;
+    if (pixelCount == 0 || !decoded) {
+        metrics.rgbPSNR = 0.0;
+        metrics.alphaPSNR = 0.0;
+        return metrics;
+    }
+
+    uint64_t rgbSquaredError = 0;
+    uint64_t alphaSquaredError = 0;
+    int maxError = 0;
+
+    // Decoders always produce RGBA, so inputs without alpha are compared as opaque
+    std::vector<uint8_t> originalRow(static_cast<size_t>(original.width) * 4);
+    for (int y = 0; y < original.height; ++y) {
+        expandRow(original, y, originalRow.data());
+        const uint8_t* decodedRow = decoded + static_cast<size_t>(y) * original.width * 4;
+        for (int x = 0; x < original.width; ++x) {
+            const uint8_t* a = &originalRow[x * 4];
+            const uint8_t* b = decodedRow + x * 4;
+            for (int c = 0; c < 3; ++c) {
+                int diff = static_cast<int>(a[c]) - static_cast<int>(b[c]);
+                rgbSquaredError += static_cast<uint64_t>(diff * diff);
+                maxError = std::max(maxError, std::abs(diff));
+            }
+            int alphaDiff = static_cast<int>(a[3]) - static_cast<int>(b[3]);
+            alphaSquaredError += static_cast<uint64_t>(alphaDiff * alphaDiff);
+            maxError = std::max(maxError, std::abs(alphaDiff));
+        }
+    }
+
+    metrics.rgbMSE = static_cast<double>(rgbSquaredError) / (pixelCount * 3);
+    metrics.alphaMSE = static_cast<double>(alphaSquaredError) / pixelCount;
+    metrics.rgbPSNR = psnrFromMSE(metrics.rgbMSE);
+    metrics.alphaPSNR = psnrFromMSE(metrics.alphaMSE);
+    metrics.maxError = maxError;
+    return metrics;
+}
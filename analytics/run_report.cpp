@@ -0,0 +1,275 @@
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "../include/analytics/run_report.h"
+#include "../include/encoder_version.h"
+#include "../include/logging/logger.h"
+
+// Version of the report layout, bumped whenever fields are renamed or removed
+static const int kRunReportSchemaVersion = 6;
+
+double RunReportRow::encodeMegapixelsPerSecond() const {
+    if (encodeSeconds <= 0.0) return 0.0;
+    return (static_cast<double>(width) * height / 1.0e6) / encodeSeconds;
+}
+
+double RunReportRow::decodeMegapixelsPerSecond() const {
+    if (decodeSeconds <= 0.0) return 0.0;
+    return (static_cast<double>(width) * height / 1.0e6) / decodeSeconds;
+}
+
+double RunReportRow::bitsPerPixel() const {
+    double pixels = static_cast<double>(width) * height;
+    if (pixels <= 0.0) return 0.0;
+    return compressedBytes * 8.0 / pixels;
+}
+
+double RunReportRow::compressionRatio() const {
+    if (compressedBytes == 0) return 0.0;
+    return (static_cast<double>(width) * height * 4.0) / compressedBytes;
+}
+
+double RunReportRow::dedupeHitRate() const {
+    if (dedupeLookups == 0) return 0.0;
+    return static_cast<double>(dedupeHits) / dedupeLookups;
+}
+
+// Helper function to format the current UTC time as ISO 8601
+static std::string currentTimeISO8601() {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm utc{};
+#if defined(_WIN32)
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return buffer;
+}
+
+// Helper function to escape a string for inclusion in JSON
+static std::string escapeJSON(const std::string& value) {
+    std::ostringstream out;
+    for (char c : value) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    return out.str();
+}
+
+// Helper function to escape a string for a CSV field
+static std::string escapeCSV(const std::string& value) {
+    if (value.find_first_of(",\"\n") == std::string::npos) {
+        return value;
+    }
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (c == '"') escaped += '"';
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+// Helper function to print a double, using null for values JSON cannot represent
+static std::string jsonNumber(double value) {
+    if (!std::isfinite(value)) {
+        return "null";
+    }
+    std::ostringstream out;
+    out << std::setprecision(10) << value;
+    return out.str();
+}
+
+// Helper function to write a counter sample as a JSON object, or null when nothing was captured
+static std::string countersJSON(const PerfCounterSample& sample) {
+    if (!sample.valid) {
+        return "null";
+    }
+    std::ostringstream out;
+    out << "{";
+    for (int c = 0; c < PerfCounterSample::CounterCount; ++c) {
+        PerfCounterSample::Counter counter = static_cast<PerfCounterSample::Counter>(c);
+        out << "\"" << PerfCounterSample::counterName(counter) << "\": ";
+        if (sample.has(counter)) {
+            out << sample.get(counter);
+        } else {
+            out << "null";
+        }
+        out << ", ";
+    }
+    out << "\"ipc\": " << ((sample.has(PerfCounterSample::Cycles) && sample.has(PerfCounterSample::Instructions)) ? jsonNumber(sample.ipc()) : "null");
+    out << "}";
+    return out.str();
+}
+
+// Helper function to write a counter sample as CSV fields, leaving missing counters empty
+static std::string countersCSV(const PerfCounterSample& sample) {
+    std::ostringstream out;
+    out << std::setprecision(10);
+    for (int c = 0; c < PerfCounterSample::CounterCount; ++c) {
+        PerfCounterSample::Counter counter = static_cast<PerfCounterSample::Counter>(c);
+        if (sample.has(counter)) {
+            out << sample.get(counter);
+        }
+        out << ',';
+    }
+    if (sample.has(PerfCounterSample::Cycles) && sample.has(PerfCounterSample::Instructions)) {
+        out << sample.ipc();
+    }
+    return out.str();
+}
+
+RunReport::RunReport() : startedAt_(currentTimeISO8601()) {}
+
+void RunReport::addRow(const RunReportRow& row) {
+    rows_.push_back(row);
+}
+
+void RunReport::addSummaryCounter(const std::string& name, uint64_t value) {
+    summaryCounters_.emplace_back(name, value);
+}
+
+bool RunReport::write(const std::string& filePath) const {
+    size_t dot = filePath.find_last_of('.');
+    if (dot != std::string::npos && filePath.substr(dot) == ".csv") {
+        return writeCSV(filePath);
+    }
+    return writeJSON(filePath);
+}
+
+bool RunReport::writeJSON(const std::string& filePath) const {
+    std::ofstream out(filePath);
+    if (!out) {
+        LOG_ERROR("Failed to open report file for writing: " << filePath);
+        return false;
+    }
+
+    out << "{\n";
+    out << "  \"schemaVersion\": " << kRunReportSchemaVersion << ",\n";
+    out << "  \"encoderVersion\": \"" << TCA_ENCODER_VERSION << "\",\n";
+    out << "  \"startedAt\": \"" << startedAt_ << "\",\n";
+    out << "  \"totalSeconds\": " << jsonNumber(totalSeconds_) << ",\n";
+    out << "  \"summary\": {";
+    for (size_t i = 0; i < summaryCounters_.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << "\"" << escapeJSON(summaryCounters_[i].first) << "\": " << summaryCounters_[i].second;
+    }
+    out << "},\n";
+    out << "  \"results\": [";
+
+    for (size_t i = 0; i < rows_.size(); ++i) {
+        const RunReportRow& row = rows_[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"input\": \"" << escapeJSON(row.inputFile) << "\",\n";
+        out << "      \"algorithm\": \"" << escapeJSON(row.algorithm) << "\",\n";
+        out << "      \"width\": " << row.width << ",\n";
+        out << "      \"height\": " << row.height << ",\n";
+        out << "      \"channels\": " << row.channels << ",\n";
+        out << "      \"mipLevels\": " << row.mipLevels << ",\n";
+        out << "      \"encodeSeconds\": " << jsonNumber(row.encodeSeconds) << ",\n";
+        out << "      \"decodeSeconds\": " << jsonNumber(row.decodeSeconds) << ",\n";
+        out << "      \"encodeMPixPerSec\": " << jsonNumber(row.encodeMegapixelsPerSecond()) << ",\n";
+        out << "      \"decodeMPixPerSec\": " << jsonNumber(row.decodeMegapixelsPerSecond()) << ",\n";
+        out << "      \"cacheHit\": " << (row.cacheHit ? "true" : "false") << ",\n";
+        if (row.dedupeLookups > 0) {
+            out << "      \"dedupe\": {\"lookups\": " << row.dedupeLookups << ", \"hits\": " << row.dedupeHits
+                << ", \"hitRate\": " << jsonNumber(row.dedupeHitRate()) << "},\n";
+        } else {
+            out << "      \"dedupe\": null,\n";
+        }
+        if (row.sequenceFrame) {
+            out << "      \"sequence\": {\"reusedExact\": " << row.sequenceReusedExact << ", \"reusedWithinError\": " << row.sequenceReusedWithinError
+                << ", \"encoded\": " << row.sequenceEncodedBlocks << "},\n";
+        } else {
+            out << "      \"sequence\": null,\n";
+        }
+        out << "      \"compressedBytes\": " << row.compressedBytes << ",\n";
+        out << "      \"bitsPerPixel\": " << jsonNumber(row.bitsPerPixel()) << ",\n";
+        out << "      \"compressionRatio\": " << jsonNumber(row.compressionRatio()) << ",\n";
+        out << "      \"encodeCounters\": " << countersJSON(row.encodeCounters) << ",\n";
+        out << "      \"decodeCounters\": " << countersJSON(row.decodeCounters) << ",\n";
+        if (row.decoded) {
+            out << "      \"quality\": {\n";
+            out << "        \"rgbMSE\": " << jsonNumber(row.quality.rgbMSE) << ",\n";
+            out << "        \"rgbPSNR\": " << jsonNumber(row.quality.rgbPSNR) << ",\n";
+            out << "        \"alphaMSE\": " << jsonNumber(row.quality.alphaMSE) << ",\n";
+            out << "        \"alphaPSNR\": " << jsonNumber(row.quality.alphaPSNR) << ",\n";
+            out << "        \"maxError\": " << row.quality.maxError << "\n";
+            out << "      }\n";
+        } else {
+            out << "      \"quality\": null\n";
+        }
+        out << "    }";
+    }
+
+    out << (rows_.empty() ? "]\n" : "\n  ]\n");
+    out << "}\n";
+    return static_cast<bool>(out);
+}
+
+bool RunReport::writeCSV(const std::string& filePath) const {
+    std::ofstream out(filePath);
+    if (!out) {
+        LOG_ERROR("Failed to open report file for writing: " << filePath);
+        return false;
+    }
+
+    out << std::setprecision(10);
+    out << "encoder_version,input,algorithm,width,height,channels,mip_levels,cache_hit,dedupe_lookups,dedupe_hits,sequence_reused_exact,sequence_reused_within_error,sequence_encoded,encode_seconds,decode_seconds,"
+           "encode_mpix_per_sec,decode_mpix_per_sec,compressed_bytes,bits_per_pixel,compression_ratio,"
+           "rgb_mse,rgb_psnr,alpha_mse,alpha_psnr,max_error,"
+           "encode_cycles,encode_instructions,encode_branch_misses,encode_l1d_misses,encode_llc_misses,encode_ipc,"
+           "decode_cycles,decode_instructions,decode_branch_misses,decode_l1d_misses,decode_llc_misses,decode_ipc\n";
+
+    for (const RunReportRow& row : rows_) {
+        out << TCA_ENCODER_VERSION << ','
+            << escapeCSV(row.inputFile) << ','
+            << escapeCSV(row.algorithm) << ','
+            << row.width << ','
+            << row.height << ','
+            << row.channels << ','
+            << row.mipLevels << ','
+            << (row.cacheHit ? 1 : 0) << ','
+            << row.dedupeLookups << ','
+            << row.dedupeHits << ',';
+        if (row.sequenceFrame) {
+            out << row.sequenceReusedExact << ',' << row.sequenceReusedWithinError << ',' << row.sequenceEncodedBlocks << ',';
+        } else {
+            out << ",,,";
+        }
+        out << row.encodeSeconds << ','
+            << row.decodeSeconds << ','
+            << row.encodeMegapixelsPerSecond() << ','
+            << row.decodeMegapixelsPerSecond() << ','
+            << row.compressedBytes << ','
+            << row.bitsPerPixel() << ','
+            << row.compressionRatio() << ',';
+        if (row.decoded) {
+            out << row.quality.rgbMSE << ','
+                << row.quality.rgbPSNR << ','
+                << row.quality.alphaMSE << ','
+                << row.quality.alphaPSNR << ','
+                << row.quality.maxError << ',';
+        } else {
+            out << ",,,,,";
+        }
+        out << countersCSV(row.encodeCounters) << ',' << countersCSV(row.decodeCounters) << '\n';
+    }
+    return static_cast<bool>(out);
+}
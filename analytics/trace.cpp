@@ -0,0 +1,188 @@
+#include "../include/analytics/trace.h"
+#include "../include/logging/logger.h"
+
+#if defined(TCA_ENABLE_TRACING)
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Number of events kept per thread before the oldest are overwritten
+const size_t kTraceBufferCapacity = 1 << 16;
+
+struct TraceEvent {
+    const char* name;
+    uint64_t startNanoseconds;
+    uint64_t durationNanoseconds;
+};
+
+// Ring buffer owned by one thread. Only that thread writes; the writer publishes
+// the head with release semantics so a dump sees completed events.
+struct TraceBuffer {
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> head{0};
+    int threadId = 0;
+    std::string threadName;
+    std::mutex nameMutex;
+};
+
+std::atomic<bool> gTraceRecording{false};
+std::chrono::steady_clock::time_point gTraceEpoch = std::chrono::steady_clock::now();
+
+// Registry of every thread's buffer. Buffers outlive their threads so a dump at
+// the end of the run still sees the events of finished workers.
+std::mutex gRegistryMutex;
+std::vector<std::shared_ptr<TraceBuffer>> gRegistry;
+
+// Buffers of exited threads, handed to the next thread that records. The codec
+// drivers start fresh workers on every call, so without reuse a traced batch would
+// keep one full buffer per worker ever started.
+std::vector<std::shared_ptr<TraceBuffer>> gFreeBuffers;
+
+uint64_t nowNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gTraceEpoch).count());
+}
+
+// A thread's hold on its buffer, released to the free list when the thread exits
+struct ThreadBufferLease {
+    std::shared_ptr<TraceBuffer> buffer;
+
+    ~ThreadBufferLease() {
+        if (buffer) {
+            std::lock_guard<std::mutex> lock(gRegistryMutex);
+            gFreeBuffers.push_back(std::move(buffer));
+        }
+    }
+};
+
+TraceBuffer& threadBuffer() {
+    thread_local ThreadBufferLease lease;
+    if (!lease.buffer) {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        if (!gFreeBuffers.empty()) {
+            // Earlier threads' events stay; they ended before this thread's begin
+            lease.buffer = std::move(gFreeBuffers.back());
+            gFreeBuffers.pop_back();
+        } else {
+            lease.buffer = std::make_shared<TraceBuffer>();
+            lease.buffer->events.resize(kTraceBufferCapacity);
+            lease.buffer->threadId = static_cast<int>(gRegistry.size()) + 1;
+            gRegistry.push_back(lease.buffer);
+        }
+    }
+    return *lease.buffer;
+}
+
+// Helper function to escape a zone or thread name for JSON
+std::string escapeJSON(const std::string& value) {
+    std::string escaped;
+    for (char c : value) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+TraceScope::TraceScope(const char* name) : name_(name), startNanoseconds_(0) {
+    if (gTraceRecording.load(std::memory_order_relaxed)) {
+        startNanoseconds_ = nowNanoseconds();
+    } else {
+        name_ = nullptr;
+    }
+}
+
+TraceScope::~TraceScope() {
+    if (!name_) {
+        return;
+    }
+    TraceBuffer& buffer = threadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % kTraceBufferCapacity] = {name_, startNanoseconds_, nowNanoseconds() - startNanoseconds_};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void traceStart() {
+    gTraceRecording.store(true, std::memory_order_relaxed);
+}
+
+void traceSetThreadName(const std::string& name) {
+    TraceBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.nameMutex);
+    buffer.threadName = name;
+}
+
+bool traceCompiledIn() {
+    return true;
+}
+
+bool traceWriteChromeJSON(const std::string& filePath) {
+    std::ofstream out(filePath);
+    if (!out) {
+        LOG_ERROR("Failed to open trace file for writing: " << filePath);
+        return false;
+    }
+
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        buffers = gRegistry;
+    }
+
+    uint64_t droppedEvents = 0;
+    bool first = true;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    for (const std::shared_ptr<TraceBuffer>& buffer : buffers) {
+        std::string threadName;
+        {
+            std::lock_guard<std::mutex> lock(buffer->nameMutex);
+            threadName = buffer->threadName.empty() ? "thread " + std::to_string(buffer->threadId) : buffer->threadName;
+        }
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->threadId
+            << ",\"args\":{\"name\":\"" << escapeJSON(threadName) << "\"}}";
+
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = head > kTraceBufferCapacity ? head - kTraceBufferCapacity : 0;
+        droppedEvents += begin;
+        for (uint64_t i = begin; i < head; ++i) {
+            const TraceEvent& event = buffer->events[i % kTraceBufferCapacity];
+            out << ",\n{\"ph\":\"X\",\"name\":\"" << escapeJSON(event.name) << "\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << event.startNanoseconds / 1000.0
+                << ",\"dur\":" << event.durationNanoseconds / 1000.0 << "}";
+        }
+    }
+
+    out << "\n],\"otherData\":{\"droppedEvents\":" << droppedEvents << "}}\n";
+    return static_cast<bool>(out);
+}
+
+#else
+
+#include <iostream>
+
+void traceStart() {}
+
+void traceSetThreadName(const std::string&) {}
+
+bool traceCompiledIn() {
+    return false;
+}
+
+bool traceWriteChromeJSON(const std::string& filePath) {
+    LOG_ERROR("Tracing was not compiled in (configure with -DENABLE_TRACING=ON); not writing " << filePath);
+    return false;
+}
+
+#endif
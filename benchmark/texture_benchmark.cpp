@@ -0,0 +1,759 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/analytics/perf_counters.h"
+#include "../include/compression/block_codec.h"
+#include "../include/compression/block_dedupe_cache.h"
+#include "../include/compression/sequence_encoder.h"
+#include "../include/corpus/synthetic_texture.h"
+#include "../include/image/mipmap.h"
+#include "../include/image/page_allocator.h"
+#include "../include/logging/logger.h"
+#include "../include/dxt/block_io.h"
+#include "../include/dxt/color_utils.h"
+#include "../include/dxt/dxt_kernels.h"
+#include "../include/dxt/dxt_reference.h"
+#include "../include/simd/dispatch.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../include/stb_image.h"
+
+// Side of the square edit used by the dirty-rectangle measurement
+const int REGION_EDIT_SIZE = 64;
+
+// Frames of the mostly-static sequence measurement
+const int SEQUENCE_FRAMES = 8;
+
+// Benchmark command line options
+struct BenchmarkOptions {
+    std::vector<int> sizes = {64, 256, 1024, 2048};
+    std::vector<std::string> contents; // Empty means every synthetic pattern
+    std::vector<std::string> formats; // Empty means every implemented format
+    std::vector<int> threadCounts;    // Empty means 1 and the hardware concurrency
+    std::vector<bool> coldCache = {false, true};
+    int repetitions = 11;
+    uint64_t seed = 1;
+    size_t flushBytes = 64u << 20; // Larger than any last-level cache we run on
+    std::string csvPath;
+    HugePageMode hugePages = HugePageMode::Off; // Also time image encode/decode on huge-page buffers
+    bool perfCounters = false; // Count branch misses over one extra run of each measurement
+    bool verify = false; // Check every kernel variant against the reference codec instead of benchmarking
+    std::string samplesDirectory = "samples"; // PNG inputs of --verify; "-" for none
+};
+
+// Summary of the repetitions of one measurement
+struct TimingStats {
+    double median = 0.0;
+    double p95 = 0.0;
+    double min = 0.0;
+    double branchMisses = -1.0; // Of the counted run; -1 when not counted
+};
+
+// Helper function to compute median, 95th percentile and minimum of a set of samples
+static TimingStats computeStats(std::vector<double> samples) {
+    TimingStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    stats.min = samples.front();
+    stats.median = (n % 2 == 1) ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+    size_t p95Index = static_cast<size_t>(0.95 * (n - 1) + 0.5);
+    stats.p95 = samples[std::min(p95Index, n - 1)];
+    return stats;
+}
+
+// Function to make a computed value observable, so the optimizer keeps the work that produced it
+template <typename T>
+static inline void keepValue(T value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(value));
+#else
+    static volatile T sink;
+    sink = value;
+    (void)sink;
+#endif
+}
+
+// Function to evict the caches by streaming over a buffer larger than the last-level cache
+static void flushCaches(std::vector<uint8_t>& flushBuffer) {
+    uint8_t accumulator = 0;
+    for (size_t i = 0; i < flushBuffer.size(); i += 64) {
+        flushBuffer[i] = static_cast<uint8_t>(flushBuffer[i] + 1);
+        accumulator ^= flushBuffer[i];
+    }
+    keepValue(accumulator);
+}
+
+// Function to get the counters shared by every measurement, opened on first use
+static PerfCounterGroup& getPerfCounters() {
+    static PerfCounterGroup counters;
+    return counters;
+}
+
+// Function to time a callable over the configured repetitions
+template <typename Function>
+static TimingStats measure(const BenchmarkOptions& options, bool cold, std::vector<uint8_t>& flushBuffer, Function function) {
+    if (!cold) {
+        function(); // Warm-up run, untimed
+    }
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    for (int r = 0; r < options.repetitions; ++r) {
+        if (cold) {
+            flushCaches(flushBuffer);
+        }
+        auto start = std::chrono::steady_clock::now();
+        function();
+        samples.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    TimingStats stats = computeStats(samples);
+
+    // Counted separately so the counter reads stay out of the timings
+    PerfCounterGroup& counters = getPerfCounters();
+    if (options.perfCounters && counters.isAvailable()) {
+        if (cold) {
+            flushCaches(flushBuffer);
+        }
+        counters.start();
+        function();
+        PerfCounterSample sample = counters.stop();
+        if (sample.has(PerfCounterSample::BranchMisses)) {
+            stats.branchMisses = static_cast<double>(sample.get(PerfCounterSample::BranchMisses));
+        }
+    }
+    return stats;
+}
+
+// Helper function to split a comma separated list
+static std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Function to parse the command line into benchmark options
+static bool parseArguments(int argc, char* argv[], BenchmarkOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue) {
+            options.sizes.clear();
+            for (const std::string& size : splitList(argv[++i])) {
+                options.sizes.push_back(std::atoi(size.c_str()));
+            }
+        } else if (arg == "--content" && hasValue) {
+            options.contents = splitList(argv[++i]);
+        } else if (arg == "--formats" && hasValue) {
+            options.formats = splitList(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            options.threadCounts.clear();
+            for (const std::string& count : splitList(argv[++i])) {
+                options.threadCounts.push_back(std::max(1, std::atoi(count.c_str())));
+            }
+        } else if (arg == "--cache" && hasValue) {
+            std::string mode = argv[++i];
+            if (mode == "warm") {
+                options.coldCache = {false};
+            } else if (mode == "cold") {
+                options.coldCache = {true};
+            } else {
+                options.coldCache = {false, true};
+            }
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--reps" && hasValue) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--flush-mb" && hasValue) {
+            options.flushBytes = static_cast<size_t>(std::max(1, std::atoi(argv[++i]))) << 20;
+        } else if (arg == "--huge-pages" && hasValue) {
+            if (!parseHugePageMode(argv[++i], options.hugePages)) {
+                std::cerr << "Unknown huge page mode: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--perf-counters") {
+            options.perfCounters = true;
+        } else if (arg == "--verify") {
+            options.verify = true;
+        } else if (arg == "--samples" && hasValue) {
+            options.samplesDirectory = argv[++i];
+        } else if (arg == "--csv" && hasValue) {
+            options.csvPath = argv[++i];
+        } else {
+            return false;
+        }
+    }
+
+    if (options.contents.empty()) {
+        for (SyntheticPattern pattern : getSyntheticPatterns()) {
+            options.contents.push_back(getSyntheticPatternName(pattern));
+        }
+    }
+    for (const std::string& content : options.contents) {
+        SyntheticPattern pattern;
+        if (!parseSyntheticPattern(content, pattern)) {
+            std::cerr << "Unknown content type: " << content << std::endl;
+            return false;
+        }
+    }
+    for (int size : options.sizes) {
+        if (size < SYNTHETIC_MIN_SIZE || size > SYNTHETIC_MAX_SIZE) {
+            std::cerr << "Size out of range: " << size << std::endl;
+            return false;
+        }
+    }
+
+    if (options.threadCounts.empty()) {
+        options.threadCounts.push_back(1);
+        int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        if (hardwareThreads > 1) {
+            options.threadCounts.push_back(hardwareThreads);
+        }
+    }
+    return true;
+}
+
+// Palette of one block, as the encoders build it
+struct BlockPalette {
+    uint8_t entries[4][4];
+};
+
+// One line of benchmark output
+struct BenchmarkResult {
+    std::string format;
+    std::string content;
+    int size;
+    std::string level;     // "block", "index", "image", "huge", "mips", "rgb", "dedupe", "region" or "seq"
+    std::string operation; // "encode" or "decode"; "exact" or "project" for index rows
+    int threads;
+    bool cold;
+    TimingStats stats;
+    double megapixelsPerSecond;
+    double nanosecondsPerBlock;
+    double branchMissesPerBlock; // -1 when not counted
+};
+
+static void printResult(const BenchmarkResult& result) {
+    std::cout << std::left << std::setw(6) << result.format
+              << std::setw(13) << result.content
+              << std::right << std::setw(6) << result.size << "  "
+              << std::left << std::setw(7) << result.level
+              << std::setw(7) << result.operation
+              << std::right << std::setw(4) << result.threads << "  "
+              << std::left << std::setw(5) << (result.cold ? "cold" : "warm")
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(11) << result.stats.median * 1e3
+              << std::setw(11) << result.stats.p95 * 1e3
+              << std::setw(11) << std::setprecision(1) << result.megapixelsPerSecond
+              << std::setw(10) << std::setprecision(2) << result.nanosecondsPerBlock;
+    if (result.branchMissesPerBlock >= 0.0) {
+        std::cout << std::setw(12) << std::setprecision(3) << result.branchMissesPerBlock;
+    } else {
+        std::cout << std::setw(12) << "-";
+    }
+    std::cout << std::defaultfloat << '\n';
+}
+
+// Kernels of one format, taken from the table of one instruction set
+struct FormatKernels {
+    void (*compressBlock)(const uint8_t* block, uint8_t* output);
+    void (*decompressBlock)(const uint8_t* input, uint8_t* block);
+    void (*compressBlockRows)(const ImageView& image, int firstBlockRow, int lastBlockRow, uint8_t* compressedData);
+    void (*decompressBlockRows)(const uint8_t* compressedData, int width, int height, int firstBlockRow, int lastBlockRow, uint8_t* textureData);
+};
+
+// Function to pick the kernels of a codec's format from a kernel table
+static FormatKernels getFormatKernels(const DXTKernels& kernels, CompressionAlgorithm algorithm) {
+    if (algorithm == CompressionAlgorithm::DXT1) {
+        return {kernels.compressBlockDXT1, kernels.decompressBlockDXT1, kernels.compressBlockRowsDXT1, kernels.decompressBlockRowsDXT1};
+    }
+    return {kernels.compressBlockDXT2, kernels.decompressBlockDXT2, kernels.compressBlockRowsDXT2, kernels.decompressBlockRowsDXT2};
+}
+
+// One image checked by --verify
+struct VerifyInput {
+    std::string name;
+    ImageBuffer image;
+};
+
+// Function to collect the --verify inputs: every synthetic pattern and size, then the PNGs of the
+// samples directory in their own channel layout. Returns false if a sample fails to load.
+static bool collectVerifyInputs(const BenchmarkOptions& options, std::vector<VerifyInput>& inputs) {
+    for (const std::string& content : options.contents) {
+        for (int size : options.sizes) {
+            SyntheticPattern pattern;
+            parseSyntheticPattern(content, pattern);
+            inputs.push_back({content, ImageBuffer::adopt(generateSyntheticTexture(pattern, size, size, options.seed), size, size)});
+        }
+    }
+
+    if (options.samplesDirectory == "-") {
+        return true;
+    }
+    std::error_code error;
+    if (!std::filesystem::is_directory(options.samplesDirectory, error)) {
+        std::cout << "samples directory " << options.samplesDirectory << " not found; verifying synthetic inputs only\n";
+        return true;
+    }
+    std::vector<std::filesystem::path> samplePaths;
+    for (const auto& entry : std::filesystem::directory_iterator(options.samplesDirectory)) {
+        if (entry.path().extension() == ".png") {
+            samplePaths.push_back(entry.path());
+        }
+    }
+    std::sort(samplePaths.begin(), samplePaths.end());
+    for (const std::filesystem::path& path : samplePaths) {
+        int width, height, channels;
+        unsigned char* texels = stbi_load(path.string().c_str(), &width, &height, &channels, 0);
+        if (!texels) {
+            std::cerr << "Failed to load " << path.string() << ": " << stbi_failure_reason() << std::endl;
+            return false;
+        }
+        inputs.push_back({path.filename().string(),
+                          ImageBuffer::adopt(texels, width, height, static_cast<size_t>(width) * channels, channels, stbi_image_free)});
+    }
+    return true;
+}
+
+// Outputs of one encoder/decoder variant on one image
+struct VerifyOutputs {
+    std::vector<uint8_t> compressed;      // Whole image, encoded by the row kernel
+    std::vector<uint8_t> decoded;         // The reference encoding, decoded by the row kernel
+    std::vector<uint8_t> blockCompressed; // Every block, encoded by the block kernel
+    std::vector<uint8_t> blockDecoded;    // The reference block encodings, decoded by the block kernel
+    std::vector<uint8_t> indices;         // Packed palette indices of every block, 4 bytes each
+};
+
+// Helper function to describe the first unit where a variant's output differs from the reference,
+// or return an empty string if they are identical
+static std::string describeMismatch(const char* what, const std::vector<uint8_t>& expected, const std::vector<uint8_t>& actual,
+                                    size_t unitBytes, const char* unit) {
+    if (expected.size() != actual.size()) {
+        return std::string(what) + " size differs";
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (expected[i] != actual[i]) {
+            return std::string(what) + " differs at " + unit + " " + std::to_string(i / unitBytes);
+        }
+    }
+    return std::string();
+}
+
+// Function to run every encoder and decoder variant against the reference codec of dxt_reference.h
+// and print their speedups over it. The block kernels and index selection, the row kernels of each
+// supported instruction set (the scalar build included) and the multithreaded image drivers must
+// all produce the reference's compressed bytes and decoded texels. Returns the number of variants
+// that did not, or 1 if an input fails to load.
+static int runVerification(const BenchmarkOptions& options, std::vector<uint8_t>& flushBuffer) {
+    std::vector<VerifyInput> inputs;
+    if (!collectVerifyInputs(options, inputs)) {
+        return 1;
+    }
+
+    std::vector<const DXTKernels*> isaKernels;
+    for (SimdIsa isa : {SimdIsa::Scalar, SimdIsa::Generic, SimdIsa::AVX2, SimdIsa::AVX512}) {
+        if (const DXTKernels* kernels = getDXTKernels(isa)) {
+            isaKernels.push_back(kernels);
+        } else {
+            std::cout << "verify: " << getSimdIsaName(isa) << " not supported by this build or CPU\n";
+        }
+    }
+    std::cout << "format input                              size  variant      encode ms  decode ms  encode x  decode x  result\n";
+
+    int mismatches = 0;
+    for (const BlockCodec& codec : getBlockCodecs()) {
+        if (!options.formats.empty() && std::find(options.formats.begin(), options.formats.end(), codec.name) == options.formats.end()) {
+            continue;
+        }
+
+        for (const VerifyInput& input : inputs) {
+            ImageView image = input.image.view();
+            int width = image.width;
+            int height = image.height;
+            int blocksX = blockCount(width);
+            int blocksY = blockCount(height);
+            size_t blocks = static_cast<size_t>(blocksX) * blocksY;
+            size_t compressedBytes = getCompressedSize(codec, width, height);
+            size_t decodedBytes = static_cast<size_t>(width) * height * 4;
+
+            // Every block, and the palette the encoders build for it, for the block and index checks
+            std::vector<uint8_t> sourceBlocks(blocks * 64);
+            std::vector<BlockPalette> blockPalettes(blocks);
+            for (int by = 0; by < blocksY; ++by) {
+                for (int bx = 0; bx < blocksX; ++bx) {
+                    size_t b = static_cast<size_t>(by) * blocksX + bx;
+                    uint8_t* block = &sourceBlocks[b * 64];
+                    extractBlock(image, bx * 4, by * 4, block);
+                    uint8_t minR = 255, minG = 255, minB = 255, maxR = 0, maxG = 0, maxB = 0;
+                    for (int j = 0; j < 64; j += 4) {
+                        minR = std::min(minR, block[j]);
+                        minG = std::min(minG, block[j + 1]);
+                        minB = std::min(minB, block[j + 2]);
+                        maxR = std::max(maxR, block[j]);
+                        maxG = std::max(maxG, block[j + 1]);
+                        maxB = std::max(maxB, block[j + 2]);
+                    }
+                    buildPalette(getPaletteTables(), rgbTo565(maxR, maxG, maxB), rgbTo565(minR, minG, minB), true, blockPalettes[b].entries);
+                }
+            }
+
+            // The reference; each variant's decoders read its encodings, so they are checked on their own
+            VerifyOutputs reference;
+            reference.compressed.resize(compressedBytes);
+            reference.decoded.resize(decodedBytes);
+            reference.blockCompressed.resize(blocks * codec.blockBytes);
+            reference.blockDecoded.resize(blocks * 64);
+            reference.indices.resize(blocks * 4);
+            compressImageReference(codec.algorithm, image, reference.compressed.data());
+            decompressImageReference(codec.algorithm, reference.compressed.data(), width, height, reference.decoded.data());
+            for (size_t b = 0; b < blocks; ++b) {
+                compressBlockReference(codec.algorithm, &sourceBlocks[b * 64], &reference.blockCompressed[b * codec.blockBytes]);
+                decompressBlockReference(codec.algorithm, &reference.blockCompressed[b * codec.blockBytes], &reference.blockDecoded[b * 64]);
+                uint32_t indices = selectPaletteIndices(&sourceBlocks[b * 64], blockPalettes[b].entries);
+                std::memcpy(&reference.indices[b * 4], &indices, 4);
+            }
+            TimingStats referenceEncode = measure(options, false, flushBuffer, [&]() {
+                compressImageReference(codec.algorithm, image, reference.compressed.data());
+            });
+            TimingStats referenceDecode = measure(options, false, flushBuffer, [&]() {
+                decompressImageReference(codec.algorithm, reference.compressed.data(), width, height, reference.decoded.data());
+            });
+
+            auto report = [&](const std::string& variant, const TimingStats& encode, const TimingStats& decode, const std::string& mismatch) {
+                std::ostringstream size;
+                size << width << 'x' << height;
+                std::cout << std::left << std::setw(7) << codec.name
+                          << std::setw(28) << input.name
+                          << std::right << std::setw(11) << size.str() << "  "
+                          << std::left << std::setw(11) << variant
+                          << std::right << std::fixed << std::setprecision(3)
+                          << std::setw(11) << encode.median * 1e3
+                          << std::setw(11) << decode.median * 1e3
+                          << std::setprecision(2)
+                          << std::setw(10) << (encode.median > 0.0 ? referenceEncode.median / encode.median : 0.0)
+                          << std::setw(10) << (decode.median > 0.0 ? referenceDecode.median / decode.median : 0.0)
+                          << "  " << (mismatch.empty() ? "ok" : "MISMATCH: " + mismatch)
+                          << std::defaultfloat << '\n';
+                if (!mismatch.empty()) {
+                    ++mismatches;
+                }
+            };
+            auto compareImage = [&](const VerifyOutputs& outputs) {
+                std::string mismatch = describeMismatch("encode", reference.compressed, outputs.compressed, codec.blockBytes, "block");
+                if (mismatch.empty()) {
+                    mismatch = describeMismatch("decode", reference.decoded, outputs.decoded, 4, "texel");
+                }
+                return mismatch;
+            };
+            report("reference", referenceEncode, referenceDecode, std::string());
+
+            // Kernels of each instruction set, single-threaded
+            for (const DXTKernels* table : isaKernels) {
+                FormatKernels kernels = getFormatKernels(*table, codec.algorithm);
+                VerifyOutputs outputs;
+                outputs.compressed.resize(compressedBytes);
+                outputs.decoded.resize(decodedBytes);
+                outputs.blockCompressed.resize(blocks * codec.blockBytes);
+                outputs.blockDecoded.resize(blocks * 64);
+                outputs.indices.resize(blocks * 4);
+                kernels.compressBlockRows(image, 0, blocksY, outputs.compressed.data());
+                kernels.decompressBlockRows(reference.compressed.data(), width, height, 0, blocksY, outputs.decoded.data());
+                for (size_t b = 0; b < blocks; ++b) {
+                    kernels.compressBlock(&sourceBlocks[b * 64], &outputs.blockCompressed[b * codec.blockBytes]);
+                    kernels.decompressBlock(&reference.blockCompressed[b * codec.blockBytes], &outputs.blockDecoded[b * 64]);
+                    uint32_t indices = table->selectPaletteIndices(&sourceBlocks[b * 64], blockPalettes[b].entries);
+                    std::memcpy(&outputs.indices[b * 4], &indices, 4);
+                }
+
+                std::string mismatch = compareImage(outputs);
+                if (mismatch.empty()) {
+                    mismatch = describeMismatch("block encode", reference.blockCompressed, outputs.blockCompressed, codec.blockBytes, "block");
+                }
+                if (mismatch.empty()) {
+                    mismatch = describeMismatch("block decode", reference.blockDecoded, outputs.blockDecoded, 64, "block");
+                }
+                if (mismatch.empty()) {
+                    mismatch = describeMismatch("index selection", reference.indices, outputs.indices, 4, "block");
+                }
+
+                TimingStats encode = measure(options, false, flushBuffer, [&]() {
+                    kernels.compressBlockRows(image, 0, blocksY, outputs.compressed.data());
+                });
+                TimingStats decode = measure(options, false, flushBuffer, [&]() {
+                    kernels.decompressBlockRows(reference.compressed.data(), width, height, 0, blocksY, outputs.decoded.data());
+                });
+                report(getSimdIsaName(table->isa), encode, decode, mismatch);
+            }
+
+            // The image drivers over the active instruction set, on every requested thread count
+            for (int threads : options.threadCounts) {
+                if (threads <= 1) {
+                    continue;
+                }
+                VerifyOutputs outputs;
+                compressImageParallel(codec, image, outputs.compressed, threads);
+                decompressImageParallel(codec, reference.compressed, width, height, outputs.decoded, threads);
+                std::string mismatch = compareImage(outputs);
+
+                TimingStats encode = measure(options, false, flushBuffer, [&]() {
+                    compressImageParallel(codec, image, outputs.compressed, threads);
+                });
+                TimingStats decode = measure(options, false, flushBuffer, [&]() {
+                    decompressImageParallel(codec, reference.compressed, width, height, outputs.decoded, threads);
+                });
+                report(getSimdIsaName(getActiveSimdIsa()) + " x" + std::to_string(threads), encode, decode, mismatch);
+            }
+        }
+    }
+
+    if (mismatches > 0) {
+        std::cout << "verify: " << mismatches << " variant(s) differ from the reference\n";
+    } else {
+        std::cout << "verify: every variant matches the reference\n";
+    }
+    return mismatches;
+}
+
+int main(int argc, char* argv[]) {
+    // Keep the console to the result table; errors still get through
+    setLogLevel(LogLevel::Warning);
+
+    BenchmarkOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--sizes 64,256,1024] [--content gradient,noise,atlas,...] [--seed N] [--formats DXT1,DXT2]"
+                  << " [--threads 1,8] [--cache warm|cold|both] [--reps N] [--flush-mb N]"
+                  << " [--huge-pages off|transparent|explicit] [--perf-counters] [--csv results.csv]"
+                  << " [--verify [--samples dir|-]]" << std::endl;
+        return 1;
+    }
+
+    std::vector<uint8_t> flushBuffer(options.flushBytes, 1);
+    BlockDedupeCache dedupeCache;
+    std::vector<BenchmarkResult> results;
+
+    std::cout << "seed " << options.seed << '\n';
+    std::cout << "simd " << getSimdIsaName(getActiveSimdIsa()) << (getDXTKernels().bmi2Packing ? " bmi2" : "") << '\n';
+    if (options.hugePages != HugePageMode::Off) {
+        // Report what the kernel actually granted; the fallbacks are silent
+        PageBuffer probe(HUGE_PAGE_BYTES, options.hugePages);
+        std::cout << "huge pages " << getHugePageModeName(options.hugePages) << ": " << getPageBackingName(probe.backing()) << '\n';
+    }
+    if (options.perfCounters && !getPerfCounters().isAvailable()) {
+        std::cout << "perf counters unavailable: " << getPerfCounters().unavailableReason() << '\n';
+    }
+    if (options.verify) {
+        return runVerification(options, flushBuffer) == 0 ? 0 : 1;
+    }
+    std::cout << "format content        size  level  op      thr  cache  median ms     p95 ms     MPix/s  ns/block  brmiss/blk\n";
+
+    for (const BlockCodec& codec : getBlockCodecs()) {
+        if (!options.formats.empty() && std::find(options.formats.begin(), options.formats.end(), codec.name) == options.formats.end()) {
+            continue;
+        }
+
+        for (const std::string& content : options.contents) {
+            for (int size : options.sizes) {
+                SyntheticPattern pattern;
+                parseSyntheticPattern(content, pattern);
+                std::vector<uint8_t> texels = generateSyntheticTexture(pattern, size, size, options.seed);
+                ImageView image(texels, size, size);
+                int blocksX = blockCount(size);
+                int blocksY = blockCount(size);
+                size_t blocks = static_cast<size_t>(blocksX) * blocksY;
+                double megapixels = static_cast<double>(size) * size / 1e6;
+
+                // Pre-extract every block so the block-level numbers measure the kernel alone
+                std::vector<uint8_t> sourceBlocks(blocks * 64);
+                for (int by = 0; by < blocksY; ++by) {
+                    for (int bx = 0; bx < blocksX; ++bx) {
+                        extractBlock(image, bx * 4, by * 4, &sourceBlocks[(static_cast<size_t>(by) * blocksX + bx) * 64]);
+                    }
+                }
+                // The palette the encoders build for each block, for the index rows
+                std::vector<BlockPalette> blockPalettes(blocks);
+                for (size_t b = 0; b < blocks; ++b) {
+                    const uint8_t* block = &sourceBlocks[b * 64];
+                    uint8_t minR = 255, minG = 255, minB = 255, maxR = 0, maxG = 0, maxB = 0;
+                    for (int j = 0; j < 64; j += 4) {
+                        minR = std::min(minR, block[j]);
+                        minG = std::min(minG, block[j + 1]);
+                        minB = std::min(minB, block[j + 2]);
+                        maxR = std::max(maxR, block[j]);
+                        maxG = std::max(maxG, block[j + 1]);
+                        maxB = std::max(maxB, block[j + 2]);
+                    }
+                    buildPalette(getPaletteTables(), rgbTo565(maxR, maxG, maxB), rgbTo565(minR, minG, minB), true, blockPalettes[b].entries);
+                }
+                // The same texels without alpha, for the native RGB input path
+                std::vector<uint8_t> rgbTexels(static_cast<size_t>(size) * size * 3);
+                for (size_t p = 0; p < static_cast<size_t>(size) * size; ++p) {
+                    std::memcpy(&rgbTexels[p * 3], &texels[p * 4], 3);
+                }
+                ImageView rgbImage(rgbTexels, size, size, 3);
+
+                // Huge-page copies of the image and its outputs, for the "huge" rows
+                PageBuffer hugeTexels;
+                PageBuffer hugeCompressed;
+                PageBuffer hugeDecoded;
+                if (options.hugePages != HugePageMode::Off) {
+                    hugeTexels = PageBuffer(texels.size(), options.hugePages);
+                    hugeCompressed = PageBuffer(getCompressedSize(codec, size, size), options.hugePages);
+                    hugeDecoded = PageBuffer(texels.size(), options.hugePages);
+                    std::memcpy(hugeTexels.data(), texels.data(), texels.size());
+                }
+                ImageView hugeImage(hugeTexels.data(), size, size, static_cast<size_t>(size) * 4);
+
+                std::vector<uint8_t> encodedBlocks(blocks * codec.blockBytes);
+                std::vector<uint8_t> decodedBlocks(blocks * 64);
+
+                std::vector<uint8_t> compressedData;
+                std::vector<uint8_t> decodedImage;
+                compressImageParallel(codec, image, compressedData, 1);
+
+                for (bool cold : options.coldCache) {
+                    auto addWorkResult = [&](const std::string& level, const std::string& operation, int threads, const TimingStats& stats,
+                                             double workMegapixels, size_t workBlocks) {
+                        BenchmarkResult result{codec.name, content, size, level, operation, threads, cold, stats,
+                                               stats.median > 0.0 ? workMegapixels / stats.median : 0.0,
+                                               stats.median * 1e9 / workBlocks,
+                                               stats.branchMisses >= 0.0 ? stats.branchMisses / workBlocks : -1.0};
+                        printResult(result);
+                        results.push_back(result);
+                    };
+                    auto addResult = [&](const std::string& level, const std::string& operation, int threads, const TimingStats& stats) {
+                        addWorkResult(level, operation, threads, stats, megapixels, blocks);
+                    };
+
+                    addResult("block", "encode", 1, measure(options, cold, flushBuffer, [&]() {
+                        for (size_t b = 0; b < blocks; ++b) {
+                            codec.compressBlock(&sourceBlocks[b * 64], &encodedBlocks[b * codec.blockBytes]);
+                        }
+                    }));
+                    addResult("block", "decode", 1, measure(options, cold, flushBuffer, [&]() {
+                        for (size_t b = 0; b < blocks; ++b) {
+                            codec.decompressBlock(&encodedBlocks[b * codec.blockBytes], &decodedBlocks[b * 64]);
+                        }
+                    }));
+
+                    // Index selection alone, exhaustive against projected, on each block's encoder palette.
+                    // DXT1 and DXT2 share it, so it is measured once.
+                    if (codec.algorithm == CompressionAlgorithm::DXT1) {
+                        const DXTKernels& kernels = getDXTKernels();
+                        addResult("index", "exact", 1, measure(options, cold, flushBuffer, [&]() {
+                            uint32_t accumulator = 0;
+                            for (size_t b = 0; b < blocks; ++b) {
+                                accumulator ^= selectPaletteIndicesExhaustive(&sourceBlocks[b * 64], blockPalettes[b].entries);
+                            }
+                            keepValue(accumulator);
+                        }));
+                        addResult("index", "project", 1, measure(options, cold, flushBuffer, [&]() {
+                            uint32_t accumulator = 0;
+                            for (size_t b = 0; b < blocks; ++b) {
+                                accumulator ^= kernels.selectPaletteIndices(&sourceBlocks[b * 64], blockPalettes[b].entries);
+                            }
+                            keepValue(accumulator);
+                        }));
+                    }
+
+                    for (int threads : options.threadCounts) {
+                        addResult("image", "encode", threads, measure(options, cold, flushBuffer, [&]() {
+                            compressImageParallel(codec, image, compressedData, threads);
+                        }));
+                        addResult("image", "decode", threads, measure(options, cold, flushBuffer, [&]() {
+                            decompressImageParallel(codec, compressedData, size, size, decodedImage, threads);
+                        }));
+                        if (options.hugePages != HugePageMode::Off) {
+                            addResult("huge", "encode", threads, measure(options, cold, flushBuffer, [&]() {
+                                compressImageParallel(codec, hugeImage, hugeCompressed.data(), threads);
+                            }));
+                            addResult("huge", "decode", threads, measure(options, cold, flushBuffer, [&]() {
+                                decompressImageParallel(codec, hugeCompressed.data(), hugeCompressed.size(), size, size, hugeDecoded.data(), threads);
+                            }));
+                        }
+                        addResult("mips", "encode", threads, measure(options, cold, flushBuffer, [&]() {
+                            compressMipChain(codec, image, MipFilter::Kaiser, threads);
+                        }));
+                    }
+
+                    addResult("rgb", "encode", 1, measure(options, cold, flushBuffer, [&]() {
+                        compressImageParallel(codec, rgbImage, compressedData, 1);
+                    }));
+
+                    addResult("dedupe", "encode", 1, measure(options, cold, flushBuffer, [&]() {
+                        dedupeCache.clear();
+                        compressImageDeduplicated(codec, image, compressedData, dedupeCache);
+                    }));
+
+                    // Dirty-rectangle update: re-encode a 64x64 edit in the middle of the image
+                    if (size > REGION_EDIT_SIZE) {
+                        int regionOrigin = (size - REGION_EDIT_SIZE) / 2;
+                        size_t regionBlocks = static_cast<size_t>(blockCount(REGION_EDIT_SIZE + regionOrigin % 4)) * blockCount(REGION_EDIT_SIZE + regionOrigin % 4);
+                        addWorkResult("region", "encode", 1, measure(options, cold, flushBuffer, [&]() {
+                            codec.recompressRegion(image, regionOrigin, regionOrigin, REGION_EDIT_SIZE, REGION_EDIT_SIZE, compressedData);
+                        }), static_cast<double>(REGION_EDIT_SIZE) * REGION_EDIT_SIZE / 1e6, regionBlocks);
+
+                        // Mostly-static sequence: a 64x64 sprite moving across an unchanged background
+                        std::vector<std::vector<uint8_t>> frames(SEQUENCE_FRAMES, texels);
+                        for (int f = 0; f < SEQUENCE_FRAMES; ++f) {
+                            int spriteX = (size - REGION_EDIT_SIZE) * f / SEQUENCE_FRAMES;
+                            for (int y = regionOrigin; y < regionOrigin + REGION_EDIT_SIZE; ++y) {
+                                for (int x = spriteX; x < spriteX + REGION_EDIT_SIZE; ++x) {
+                                    uint8_t* texel = &frames[f][(static_cast<size_t>(y) * size + x) * 4];
+                                    texel[0] = static_cast<uint8_t>(255 - texel[0]);
+                                    texel[1] = static_cast<uint8_t>(255 - texel[1]);
+                                }
+                            }
+                        }
+                        SequenceEncoder sequenceEncoder(codec, size, size);
+                        addWorkResult("seq", "encode", 1, measure(options, cold, flushBuffer, [&]() {
+                            sequenceEncoder.reset();
+                            for (const std::vector<uint8_t>& frame : frames) {
+                                sequenceEncoder.encodeFrame(ImageView(frame, size, size), compressedData);
+                            }
+                        }), megapixels * SEQUENCE_FRAMES, blocks * SEQUENCE_FRAMES);
+                    }
+                }
+            }
+        }
+    }
+
+    if (!options.csvPath.empty()) {
+        std::ofstream csv(options.csvPath);
+        if (!csv) {
+            std::cerr << "Failed to open CSV file for writing: " << options.csvPath << std::endl;
+            return 1;
+        }
+        csv << "format,content,size,level,operation,threads,cache,median_seconds,p95_seconds,min_seconds,mpix_per_sec,ns_per_block,branch_misses_per_block\n";
+        csv << std::setprecision(10);
+        for (const BenchmarkResult& result : results) {
+            csv << result.format << ',' << result.content << ',' << result.size << ',' << result.level << ','
+                << result.operation << ',' << result.threads << ',' << (result.cold ? "cold" : "warm") << ','
+                << result.stats.median << ',' << result.stats.p95 << ',' << result.stats.min << ','
+                << result.megapixelsPerSecond << ',' << result.nanosecondsPerBlock << ',';
+            if (result.branchMissesPerBlock >= 0.0) {
+                csv << result.branchMissesPerBlock;
+            }
+            csv << '\n';
+        }
+    }
+
+    return 0;
+}
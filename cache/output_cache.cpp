@@ -0,0 +1,153 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include "../include/cache/output_cache.h"
+#include "../include/cache/xxhash64.h"
+#include "../include/encoder_version.h"
+#include "../include/logging/logger.h"
+
+namespace fs = std::filesystem;
+
+// Helper function to format a key as 16 hex digits
+static std::string keyToHex(uint64_t key) {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(key));
+    return buffer;
+}
+
+// Helper function to place source at destination as a hard link, or a copy if linking fails
+static bool linkOrCopy(const fs::path& source, const fs::path& destination, OutputCacheStats& stats) {
+    std::error_code error;
+    fs::remove(destination, error);
+    fs::create_hard_link(source, destination, error);
+    if (!error) {
+        ++stats.linkedFiles;
+    } else if (fs::copy_file(source, destination, fs::copy_options::overwrite_existing, error)) {
+        ++stats.copiedFiles;
+    } else {
+        LOG_ERROR("Failed to restore cached output " << destination.string() << ": " << error.message());
+        return false;
+    }
+    stats.bytesRestored += fs::file_size(destination, error);
+    return true;
+}
+
+// Helper function to copy a file into the cache via a temporary name so readers never see partial entries
+static bool publishToCache(const fs::path& source, const fs::path& destination) {
+    std::error_code error;
+    fs::path temporary = destination;
+    temporary += ".tmp";
+    if (!fs::copy_file(source, temporary, fs::copy_options::overwrite_existing, error)) {
+        LOG_ERROR("Failed to store " << source.string() << " in cache: " << error.message());
+        return false;
+    }
+    fs::rename(temporary, destination, error);
+    if (error) {
+        LOG_ERROR("Failed to store " << source.string() << " in cache: " << error.message());
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+// Helper function to read an entry's .info file: the compressed bytes and mip count on one line
+static bool readEntryInfo(const fs::path& path, OutputCacheEntryInfo& info) {
+    std::ifstream in(path);
+    OutputCacheEntryInfo read;
+    if (!(in >> read.compressedBytes >> read.mipLevels) || read.mipLevels < 1) {
+        return false;
+    }
+    info = read;
+    return true;
+}
+
+// Helper function to write an entry's .info file via a temporary name, as publishToCache does
+static bool writeEntryInfo(const fs::path& destination, const OutputCacheEntryInfo& info) {
+    std::error_code error;
+    fs::path temporary = destination;
+    temporary += ".tmp";
+    {
+        std::ofstream out(temporary);
+        out << info.compressedBytes << ' ' << info.mipLevels << '\n';
+        if (!out) {
+            LOG_ERROR("Failed to store " << destination.string() << " in cache");
+            out.close();
+            fs::remove(temporary, error);
+            return false;
+        }
+    }
+    fs::rename(temporary, destination, error);
+    if (error) {
+        LOG_ERROR("Failed to store " << destination.string() << " in cache: " << error.message());
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+OutputCache::OutputCache(const std::string& directory) : directory_(directory) {
+    std::error_code error;
+    fs::create_directories(directory_, error);
+    if (error) {
+        LOG_ERROR("Failed to create cache directory " << directory_ << ": " << error.message());
+    }
+}
+
+uint64_t OutputCache::hashPixels(const ImageView& image) {
+    if (image.empty()) {
+        return xxHash64(nullptr, 0);
+    }
+    if (image.isPacked()) {
+        return xxHash64(image.data, image.stride * image.height);
+    }
+    // Same digest as hashing the rows packed together
+    XXHash64 hash;
+    for (int y = 0; y < image.height; ++y) {
+        hash.update(image.row(y), image.rowBytes());
+    }
+    return hash.digest();
+}
+
+uint64_t OutputCache::computeKey(uint64_t pixelHash, int width, int height, CompressionAlgorithm algorithm, const std::string& settings) {
+    XXHash64 key;
+    key.update(&pixelHash, sizeof(pixelHash));
+    int32_t dimensions[2] = {width, height};
+    key.update(dimensions, sizeof(dimensions));
+    std::string identity = getAlgorithmName(algorithm) + '\n' + TCA_ENCODER_VERSION + '\n' + settings;
+    key.update(identity.data(), identity.size());
+    return key.digest();
+}
+
+std::string OutputCache::entryPath(uint64_t key, const char* extension) const {
+    std::string hex = keyToHex(key);
+    return (fs::path(directory_) / hex.substr(0, 2) / (hex + extension)).string();
+}
+
+bool OutputCache::restore(uint64_t key, const std::string& compressedFilePath, const std::string& decodedFilePath, OutputCacheEntryInfo& info) {
+    std::error_code error;
+    fs::path cachedCompressed = entryPath(key, ".compressed");
+    fs::path cachedDecoded = entryPath(key, ".png");
+    if (!fs::exists(cachedCompressed, error) || !fs::exists(cachedDecoded, error) || !readEntryInfo(entryPath(key, ".info"), info)) {
+        ++stats_.misses;
+        return false;
+    }
+
+    if (!linkOrCopy(cachedCompressed, compressedFilePath, stats_) || !linkOrCopy(cachedDecoded, decodedFilePath, stats_)) {
+        ++stats_.misses;
+        return false;
+    }
+    ++stats_.hits;
+    return true;
+}
+
+void OutputCache::store(uint64_t key, const std::string& compressedFilePath, const std::string& decodedFilePath, const OutputCacheEntryInfo& info) {
+    std::error_code error;
+    fs::path cachedCompressed = entryPath(key, ".compressed");
+    fs::create_directories(cachedCompressed.parent_path(), error);
+
+    // The .compressed file marks a complete entry, so publish it last
+    if (publishToCache(decodedFilePath, entryPath(key, ".png")) && writeEntryInfo(entryPath(key, ".info"), info) &&
+        publishToCache(compressedFilePath, cachedCompressed)) {
+        ++stats_.stores;
+    }
+}
@@ -0,0 +1,166 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include "../include/cache/run_manifest.h"
+#include "../include/logging/logger.h"
+
+namespace fs = std::filesystem;
+
+// First line of every manifest; bump the version when the layout changes
+static const char* kManifestHeader = "TextureCompressionAlgorithmAnalytics manifest 2";
+
+// Helper function to split a tab separated line
+static std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, '\t')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+bool RunManifest::load(const std::string& filePath) {
+    entries_.clear();
+    settings_.clear();
+
+    std::ifstream in(filePath);
+    if (!in) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(in, line) || line != kManifestHeader) {
+        LOG_WARNING("Ignoring manifest with unknown format: " << filePath);
+        return false;
+    }
+
+    ManifestEntry* current = nullptr;
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields = splitFields(line);
+        if (fields.empty()) {
+            continue;
+        }
+        try {
+            if (fields[0] == "settings" && fields.size() == 2) {
+                settings_ = fields[1];
+            } else if (fields[0] == "input" && fields.size() == 4) {
+                ManifestEntry& entry = entries_[fields[1]];
+                entry.inputSize = std::stoull(fields[2]);
+                entry.inputModifiedTime = std::stoll(fields[3]);
+                current = &entry;
+            } else if (fields[0] == "output" && fields.size() == 4 && current) {
+                ManifestOutput output;
+                output.path = fields[1];
+                output.size = std::stoull(fields[2]);
+                output.modifiedTime = std::stoll(fields[3]);
+                current->outputs.push_back(output);
+            }
+        } catch (const std::exception&) {
+            LOG_WARNING("Ignoring corrupt manifest: " << filePath);
+            entries_.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RunManifest::save(const std::string& filePath) const {
+    std::string temporaryPath = filePath + ".tmp";
+    {
+        std::ofstream out(temporaryPath);
+        if (!out) {
+            LOG_ERROR("Failed to open manifest for writing: " << temporaryPath);
+            return false;
+        }
+        out << kManifestHeader << '\n';
+        out << "settings\t" << settings_ << '\n';
+        for (const auto& item : entries_) {
+            out << "input\t" << item.first << '\t' << item.second.inputSize << '\t' << item.second.inputModifiedTime << '\n';
+            for (const ManifestOutput& output : item.second.outputs) {
+                out << "output\t" << output.path << '\t' << output.size << '\t' << output.modifiedTime << '\n';
+            }
+        }
+        if (!out) {
+            LOG_ERROR("Failed to write manifest: " << temporaryPath);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    fs::rename(temporaryPath, filePath, error);
+    if (error) {
+        LOG_ERROR("Failed to replace manifest " << filePath << ": " << error.message());
+        return false;
+    }
+    return true;
+}
+
+bool RunManifest::isUpToDate(const std::string& inputPath, uint64_t inputSize, int64_t inputModifiedTime) const {
+    const ManifestEntry* entry = find(inputPath);
+    if (!entry || entry->inputSize != inputSize || entry->inputModifiedTime != inputModifiedTime || entry->outputs.empty()) {
+        return false;
+    }
+
+    // Only a stat per output: a deleted, resized or rewritten output forces reprocessing
+    for (const ManifestOutput& output : entry->outputs) {
+        uint64_t size;
+        int64_t modifiedTime;
+        if (!statInput(output.path, size, modifiedTime) || size != output.size || modifiedTime != output.modifiedTime) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const ManifestEntry* RunManifest::find(const std::string& inputPath) const {
+    auto it = entries_.find(inputPath);
+    return it == entries_.end() ? nullptr : &it->second;
+}
+
+void RunManifest::set(const std::string& inputPath, const ManifestEntry& entry) {
+    entries_[inputPath] = entry;
+}
+
+size_t RunManifest::removeOutputsOfMissingInputs() {
+    size_t removed = 0;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        std::error_code error;
+        if (fs::exists(it->first, error)) {
+            ++it;
+            continue;
+        }
+        for (const ManifestOutput& output : it->second.outputs) {
+            if (fs::remove(output.path, error)) {
+                LOG_INFO("Removed output of deleted input " << it->first << ": " << output.path);
+                ++removed;
+            }
+        }
+        it = entries_.erase(it);
+    }
+    return removed;
+}
+
+ManifestOutput RunManifest::describeOutput(const std::string& path) {
+    ManifestOutput output;
+    output.path = path;
+    if (!statInput(path, output.size, output.modifiedTime)) {
+        output.size = 0;
+        output.modifiedTime = 0;
+    }
+    return output;
+}
+
+bool RunManifest::statInput(const std::string& path, uint64_t& size, int64_t& modifiedTime) {
+    std::error_code error;
+    size = fs::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    auto time = fs::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    modifiedTime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
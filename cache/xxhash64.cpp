@@ -0,0 +1,131 @@
+#include <cstring>
+#include "../include/cache/xxhash64.h"
+
+namespace {
+
+const uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+const uint64_t kPrime3 = 0x165667B19E3779F9ull;
+const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+const uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Little-endian loads regardless of host byte order
+inline uint64_t read64(const unsigned char* p) {
+    return static_cast<uint64_t>(p[0]) | (static_cast<uint64_t>(p[1]) << 8) | (static_cast<uint64_t>(p[2]) << 16) |
+           (static_cast<uint64_t>(p[3]) << 24) | (static_cast<uint64_t>(p[4]) << 32) | (static_cast<uint64_t>(p[5]) << 40) |
+           (static_cast<uint64_t>(p[6]) << 48) | (static_cast<uint64_t>(p[7]) << 56);
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * kPrime2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t hash, uint64_t accumulator) {
+    hash ^= round(0, accumulator);
+    return hash * kPrime1 + kPrime4;
+}
+
+// Function to hash the tail (< 32 bytes) and apply the final avalanche
+uint64_t finalize(uint64_t hash, const unsigned char* p, size_t length) {
+    while (length >= 8) {
+        hash ^= round(0, read64(p));
+        hash = rotateLeft(hash, 27) * kPrime1 + kPrime4;
+        p += 8;
+        length -= 8;
+    }
+    if (length >= 4) {
+        hash ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        hash = rotateLeft(hash, 23) * kPrime2 + kPrime3;
+        p += 4;
+        length -= 4;
+    }
+    while (length > 0) {
+        hash ^= (*p) * kPrime5;
+        hash = rotateLeft(hash, 11) * kPrime1;
+        ++p;
+        --length;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+} // namespace
+
+uint64_t xxHash64(const void* data, size_t length, uint64_t seed) {
+    XXHash64 state(seed);
+    state.update(data, length);
+    return state.digest();
+}
+
+XXHash64::XXHash64(uint64_t seed) : seed_(seed), totalLength_(0), bufferSize_(0) {
+    accumulators_[0] = seed + kPrime1 + kPrime2;
+    accumulators_[1] = seed + kPrime2;
+    accumulators_[2] = seed;
+    accumulators_[3] = seed - kPrime1;
+}
+
+void XXHash64::update(const void* data, size_t length) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    totalLength_ += length;
+
+    // Top up a partially filled stripe first
+    if (bufferSize_ > 0) {
+        size_t take = 32 - bufferSize_ < length ? 32 - bufferSize_ : length;
+        std::memcpy(buffer_ + bufferSize_, p, take);
+        bufferSize_ += take;
+        p += take;
+        length -= take;
+        if (bufferSize_ < 32) {
+            return;
+        }
+        for (int lane = 0; lane < 4; ++lane) {
+            accumulators_[lane] = round(accumulators_[lane], read64(buffer_ + lane * 8));
+        }
+        bufferSize_ = 0;
+    }
+
+    while (length >= 32) {
+        accumulators_[0] = round(accumulators_[0], read64(p));
+        accumulators_[1] = round(accumulators_[1], read64(p + 8));
+        accumulators_[2] = round(accumulators_[2], read64(p + 16));
+        accumulators_[3] = round(accumulators_[3], read64(p + 24));
+        p += 32;
+        length -= 32;
+    }
+
+    if (length > 0) {
+        std::memcpy(buffer_, p, length);
+        bufferSize_ = length;
+    }
+}
+
+uint64_t XXHash64::digest() const {
+    uint64_t hash;
+    if (totalLength_ >= 32) {
+        hash = rotateLeft(accumulators_[0], 1) + rotateLeft(accumulators_[1], 7) +
+               rotateLeft(accumulators_[2], 12) + rotateLeft(accumulators_[3], 18);
+        for (int lane = 0; lane < 4; ++lane) {
+            hash = mergeRound(hash, accumulators_[lane]);
+        }
+    } else {
+        hash = seed_ + kPrime5;
+    }
+    hash += totalLength_;
+    return finalize(hash, buffer_, bufferSize_);
+}
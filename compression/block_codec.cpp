@@ -0,0 +1,74 @@
+#include <iostream>
+#include <vector>
+#include "../include/compression/block_codec.h"
+#include "../include/dxt/block_io.h"
+#include "../include/dxt/dxt.h"
+#include "../include/dxt/dxt_kernels.h"
+#include "../include/thread_ranges.h"
+#include "../include/analytics/trace.h"
+#include "../include/logging/logger.h"
+
+// Helper function to build the codec table. The block kernels come straight from the table of
+// the active instruction set, without the dispatch in the dxt.h entry points.
+static std::vector<BlockCodec> createBlockCodecs() {
+    const DXTKernels& kernels = getDXTKernels();
+    return {
+        {CompressionAlgorithm::DXT1, "DXT1", DXT1_BLOCK_BYTES,
+         kernels.compressBlockDXT1, kernels.decompressBlockDXT1, compressBlockRowsDXT1, decompressBlockRowsDXT1, recompressRegionDXT1},
+        {CompressionAlgorithm::DXT2, "DXT2", DXT2_BLOCK_BYTES,
+         kernels.compressBlockDXT2, kernels.decompressBlockDXT2, compressBlockRowsDXT2, decompressBlockRowsDXT2, recompressRegionDXT2},
+    };
+}
+
+const std::vector<BlockCodec>& getBlockCodecs() {
+    static const std::vector<BlockCodec> codecs = createBlockCodecs();
+    return codecs;
+}
+
+const BlockCodec* findBlockCodec(CompressionAlgorithm algorithm) {
+    for (const BlockCodec& codec : getBlockCodecs()) {
+        if (codec.algorithm == algorithm) {
+            return &codec;
+        }
+    }
+    return nullptr;
+}
+
+size_t getCompressedSize(const BlockCodec& codec, int width, int height) {
+    return static_cast<size_t>(blockCount(width)) * blockCount(height) * codec.blockBytes;
+}
+
+void compressImageParallel(const BlockCodec& codec, const ImageView& image, std::vector<uint8_t>& compressedData, int threadCount) {
+    compressedData.resize(getCompressedSize(codec, image.width, image.height));
+    compressImageParallel(codec, image, compressedData.data(), threadCount);
+}
+
+void compressImageParallel(const BlockCodec& codec, const ImageView& image, uint8_t* compressedData, int threadCount) {
+    TRACE_SCOPE("compressImageParallel");
+    uint8_t* output = compressedData;
+    forEachRowRange(blockCount(image.height), threadCount, [&](int firstRow, int lastRow) {
+        codec.compressBlockRows(image, firstRow, lastRow, output);
+    });
+}
+
+void decompressImageParallel(const BlockCodec& codec, const std::vector<uint8_t>& compressedData, int width, int height, std::vector<uint8_t>& textureData, int threadCount) {
+    decompressImageParallel(codec, compressedData.data(), compressedData.size(), width, height, textureData, threadCount);
+}
+
+void decompressImageParallel(const BlockCodec& codec, const uint8_t* compressedData, size_t compressedBytes, int width, int height, std::vector<uint8_t>& textureData, int threadCount) {
+    textureData.resize(static_cast<size_t>(width) * height * 4);
+    decompressImageParallel(codec, compressedData, compressedBytes, width, height, textureData.data(), threadCount);
+}
+
+bool decompressImageParallel(const BlockCodec& codec, const uint8_t* compressedData, size_t compressedBytes, int width, int height, uint8_t* textureData, int threadCount) {
+    TRACE_SCOPE("decompressImageParallel");
+    if (compressedBytes < getCompressedSize(codec, width, height)) {
+        LOG_ERROR_RATE_LIMITED("Compressed data is too small for the given dimensions.");
+        return false;
+    }
+    const uint8_t* input = compressedData;
+    forEachRowRange(blockCount(height), threadCount, [&](int firstRow, int lastRow) {
+        codec.decompressBlockRows(input, width, height, firstRow, lastRow, textureData);
+    });
+    return true;
+}
@@ -0,0 +1,76 @@
+#include <cstring>
+#include "../include/compression/block_dedupe_cache.h"
+#include "../include/cache/xxhash64.h"
+#include "../include/dxt/block_io.h"
+#include "../include/analytics/trace.h"
+
+// Slots visited before giving up and replacing the home slot
+static const size_t MAX_PROBES = 8;
+
+BlockDedupeCache::BlockDedupeCache(int capacityLog2)
+    : tags_(static_cast<size_t>(1) << capacityLog2), payloads_(tags_.size()), mask_(tags_.size() - 1) {
+    for (SlotTag& tag : tags_) {
+        tag.generation = 0;
+    }
+}
+
+bool BlockDedupeCache::compressBlock(const BlockCodec& codec, const uint8_t* block, uint8_t* output) {
+    ++stats_.lookups;
+    uint32_t algorithm = static_cast<uint32_t>(codec.algorithm);
+    uint64_t hash = xxHash64(block, 64, algorithm);
+
+    size_t home = static_cast<size_t>(hash) & mask_;
+    size_t target = home;
+    for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+        size_t index = (home + probe) & mask_;
+        const SlotTag& tag = tags_[index];
+        if (tag.generation != generation_) {
+            target = index; // First free slot ends the probe sequence
+            break;
+        }
+        if (tag.hash == hash && tag.algorithm == algorithm && std::memcmp(payloads_[index].block, block, 64) == 0) {
+            std::memcpy(output, payloads_[index].encoded, codec.blockBytes);
+            ++stats_.hits;
+            return true;
+        }
+    }
+
+    codec.compressBlock(block, output);
+    tags_[target] = {hash, generation_, algorithm};
+    std::memcpy(payloads_[target].block, block, 64);
+    std::memcpy(payloads_[target].encoded, output, codec.blockBytes);
+    return false;
+}
+
+void BlockDedupeCache::clear() {
+    if (++generation_ == 0) {
+        // Wrapped around: stale slots could look live again, so reset them for real
+        for (SlotTag& tag : tags_) {
+            tag.generation = 0;
+        }
+        generation_ = 1;
+    }
+}
+
+BlockDedupeStats compressImageDeduplicated(const BlockCodec& codec, const ImageView& image, std::vector<uint8_t>& compressedData,
+                                           BlockDedupeCache& cache) {
+    TRACE_SCOPE("compressImageDeduplicated");
+    compressedData.resize(getCompressedSize(codec, image.width, image.height));
+
+    BlockDedupeStats imageStats;
+    int blocksX = blockCount(image.width);
+    int blocksY = blockCount(image.height);
+    uint8_t* output = compressedData.data();
+    uint8_t block[64];
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            extractBlock(image, bx * 4, by * 4, block);
+            ++imageStats.lookups;
+            if (cache.compressBlock(codec, block, output)) {
+                ++imageStats.hits;
+            }
+            output += codec.blockBytes;
+        }
+    }
+    return imageStats;
+}
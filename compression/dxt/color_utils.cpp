@@ -0,0 +1,113 @@
+#include "../../include/dxt/color_utils.h"
+
+// Helper function to interpolate one channel a third of the way from endpoint a to endpoint b.
+// a and b are the raw bits; green selects the 6-bit channel.
+static constexpr int interpolateThird(DecoderProfile profile, int a, int b, bool green) {
+    int ea = green ? EXPAND6.values[a] : EXPAND5.values[a];
+    int eb = green ? EXPAND6.values[b] : EXPAND5.values[b];
+    switch (profile) {
+        case DecoderProfile::Legacy:
+            return (2 * ea + eb) / 3;
+        case DecoderProfile::D3D10:
+            return (2 * ea + eb + 1) / 3;
+        case DecoderProfile::NVIDIA:
+            if (green) {
+                int difference = eb - ea;
+                return (256 * ea + difference / 4 + 128 + difference * 80) / 256;
+            }
+            return ((2 * a + b) * 22) / 8;
+        case DecoderProfile::AMD:
+            return (43 * ea + 21 * eb + 32) >> 6;
+    }
+    return 0;
+}
+
+// Helper function to interpolate the midpoint of one channel for the DXT1 3-color mode
+static constexpr int interpolateHalf(DecoderProfile profile, int a, int b, bool green) {
+    int ea = green ? EXPAND6.values[a] : EXPAND5.values[a];
+    int eb = green ? EXPAND6.values[b] : EXPAND5.values[b];
+    switch (profile) {
+        case DecoderProfile::Legacy:
+            return (ea + eb) / 2;
+        case DecoderProfile::D3D10:
+        case DecoderProfile::AMD:
+            return (ea + eb + 1) / 2;
+        case DecoderProfile::NVIDIA:
+            if (green) {
+                int difference = eb - ea;
+                return (256 * ea + difference / 4 + 128 + difference * 128) / 256;
+            }
+            return ((a + b) * 33) / 8;
+    }
+    return 0;
+}
+
+// Helper function building the tables of a profile at compile time
+static constexpr PaletteTables makePaletteTables(DecoderProfile profile) {
+    PaletteTables tables{};
+    for (int a = 0; a < 64; ++a) {
+        for (int b = 0; b < 64; ++b) {
+            if (a < 32 && b < 32) {
+                tables.third5[a][b] = static_cast<uint8_t>(interpolateThird(profile, a, b, false));
+                tables.half5[a][b] = static_cast<uint8_t>(interpolateHalf(profile, a, b, false));
+            }
+            tables.third6[a][b] = static_cast<uint8_t>(interpolateThird(profile, a, b, true));
+            tables.half6[a][b] = static_cast<uint8_t>(interpolateHalf(profile, a, b, true));
+        }
+    }
+    return tables;
+}
+
+static constexpr PaletteTables LEGACY_TABLES = makePaletteTables(DecoderProfile::Legacy);
+static constexpr PaletteTables D3D10_TABLES = makePaletteTables(DecoderProfile::D3D10);
+static constexpr PaletteTables NVIDIA_TABLES = makePaletteTables(DecoderProfile::NVIDIA);
+static constexpr PaletteTables AMD_TABLES = makePaletteTables(DecoderProfile::AMD);
+
+static_assert(D3D10_TABLES.third5[31][0] == 170 && D3D10_TABLES.third6[0][63] == 85, "Exact thirds of the full range");
+static_assert(NVIDIA_TABLES.third5[31][31] == 255 && NVIDIA_TABLES.half6[63][63] == 255, "NVIDIA interpolation keeps equal endpoints");
+
+static DecoderProfile selectedProfile = DecoderProfile::D3D10;
+static const PaletteTables* selectedTables = &D3D10_TABLES;
+
+std::string getDecoderProfileName(DecoderProfile profile) {
+    switch (profile) {
+        case DecoderProfile::Legacy: return "legacy";
+        case DecoderProfile::D3D10: return "d3d10";
+        case DecoderProfile::NVIDIA: return "nvidia";
+        case DecoderProfile::AMD: return "amd";
+    }
+    return "unknown";
+}
+
+bool parseDecoderProfile(const std::string& name, DecoderProfile& profile) {
+    for (DecoderProfile candidate : {DecoderProfile::Legacy, DecoderProfile::D3D10, DecoderProfile::NVIDIA, DecoderProfile::AMD}) {
+        if (name == getDecoderProfileName(candidate)) {
+            profile = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void setDecoderProfile(DecoderProfile profile) {
+    selectedProfile = profile;
+    selectedTables = &getPaletteTables(profile);
+}
+
+DecoderProfile getDecoderProfile() {
+    return selectedProfile;
+}
+
+const PaletteTables& getPaletteTables(DecoderProfile profile) {
+    switch (profile) {
+        case DecoderProfile::Legacy: return LEGACY_TABLES;
+        case DecoderProfile::NVIDIA: return NVIDIA_TABLES;
+        case DecoderProfile::AMD: return AMD_TABLES;
+        case DecoderProfile::D3D10: break;
+    }
+    return D3D10_TABLES;
+}
+
+const PaletteTables& getPaletteTables() {
+    return *selectedTables;
+}
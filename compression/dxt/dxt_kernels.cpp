@@ -0,0 +1,23 @@
+#include "../../include/dxt/dxt_kernels.h"
+
+// Helper function to list the tables this build has, indexed by SimdIsa
+static const DXTKernels* const (&getBuiltDXTKernels())[SIMD_ISA_COUNT] {
+#ifdef TCA_SIMD_X86_TARGETS
+    static const DXTKernels* const tables[SIMD_ISA_COUNT] = {&getDXTKernelsScalar(), &getDXTKernelsGeneric(), &getDXTKernelsAVX2(), &getDXTKernelsAVX512()};
+#else
+    static const DXTKernels* const tables[SIMD_ISA_COUNT] = {&getDXTKernelsScalar(), &getDXTKernelsGeneric(), nullptr, nullptr};
+#endif
+    return tables;
+}
+
+const DXTKernels* getDXTKernels(SimdIsa isa) {
+    if (!isSimdIsaSupported(isa)) {
+        return nullptr;
+    }
+    return getBuiltDXTKernels()[static_cast<int>(isa)];
+}
+
+const DXTKernels& getDXTKernels() {
+    static const DXTKernels& kernels = selectSimdTable(getBuiltDXTKernels(), getActiveSimdIsa());
+    return kernels;
+}
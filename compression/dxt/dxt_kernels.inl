@@ -0,0 +1,339 @@
+// DXT1 and DXT2 kernels, included once by each dxt_kernels_<isa>.cpp translation unit after it
+// defines DXT_KERNELS_ISA (a SimdIsa enumerator) and is compiled with that instruction set's
+// flags. The source is the same for every instruction set: the vector width comes from
+// include/simd/simd.h. Where the flags include BMI2 (TCA_SIMD_BMI2), every kernel is built
+// twice, with pext/pdep index packing and with the portable packing, and the getter returns the
+// BMI2 table only if the CPU runs pdep/pext in hardware.
+//
+// Nothing compiled here may share a symbol with another instruction set's copy: the kernels are
+// static, and the helpers of the shared headers live in TCA_ISA_NAMESPACE (see simd.h), so
+// out-of-line copies emitted without inlining stay distinct. For the same reason the kernels
+// avoid std:: templates such as std::min. Every kernel is flattened; the block encoders stay
+// separate functions under the row loops, since inlined into all four channel-count loops the
+// AVX-512 encoder ran at a third of its standalone speed.
+
+#include <cstdint>
+#include <cstring>
+#include "../../include/dxt/block_io.h"
+#include "../../include/dxt/color_utils.h"
+#include "../../include/dxt/dxt.h"
+#include "../../include/dxt/dxt_block.h"
+#include "../../include/dxt/dxt_kernels.h"
+#include "../../include/dxt/index_packing.h"
+#include "../../include/simd/cpu_features.h"
+#include "../../include/simd/simd.h"
+
+#ifndef DXT_KERNELS_ISA
+#error "Define DXT_KERNELS_ISA before including dxt_kernels.inl"
+#endif
+
+#define DXT_KERNELS_CONCAT(prefix, isa) prefix##isa
+#define DXT_KERNELS_TABLE(isa) DXT_KERNELS_CONCAT(getDXTKernels, isa)
+
+using TCA_SIMD_NAMESPACE::VecI32;
+
+// Helper function to pick palette indices for 16 RGBA texels of a 4-color palette, one byte per
+// texel: selectPaletteIndexFields from color_utils.h on VecI32::LANES texels at a time, with the
+// same integer arithmetic, so the indices are identical.
+TCA_FLATTEN static inline void selectPaletteIndexFieldsVector(const uint8_t* block, const uint8_t palette[4][4], uint8_t* indices) {
+    // Entries in axis order
+    int axis[4][3];
+    for (int position = 0; position < 4; ++position) {
+        int index = (AXIS_POSITION_INDICES >> (2 * position)) & 0x03;
+        axis[position][0] = palette[index][0];
+        axis[position][1] = palette[index][1];
+        axis[position][2] = palette[index][2];
+    }
+    int dirR = axis[3][0] - axis[0][0];
+    int dirG = axis[3][1] - axis[0][1];
+    int dirB = axis[3][2] - axis[0][2];
+    int third = (axis[1][0] - axis[0][0]) * dirR + (axis[1][1] - axis[0][1]) * dirG + (axis[1][2] - axis[0][2]) * dirB;
+    int twoThirds = (axis[2][0] - axis[0][0]) * dirR + (axis[2][1] - axis[0][1]) * dirG + (axis[2][2] - axis[0][2]) * dirB;
+
+#ifdef TCA_BIG_ENDIAN
+    const int shiftR = 24, shiftG = 16, shiftB = 8;
+#else
+    const int shiftR = 0, shiftG = 8, shiftB = 16;
+#endif
+
+    for (int k = 0; k < 16; k += VecI32::LANES) {
+        VecI32 texels = VecI32::load(block + k * 4);
+        VecI32 r = (texels >> shiftR) & VecI32(0xFF);
+        VecI32 g = (texels >> shiftG) & VecI32(0xFF);
+        VecI32 b = (texels >> shiftB) & VecI32(0xFF);
+
+        // Segment between the interpolated entries the texel projects into; masks are -1
+        VecI32 projection = (r - axis[0][0]) * dirR + (g - axis[0][1]) * dirG + (b - axis[0][2]) * dirB;
+        VecI32 lower = VecI32(0) - (projection > third) - (projection > twoThirds);
+        VecI32 inFirst = lower == 0;
+        VecI32 inSecond = lower == 1;
+
+        VecI32 lowerR = select(inFirst, VecI32(axis[0][0]), select(inSecond, VecI32(axis[1][0]), VecI32(axis[2][0])));
+        VecI32 lowerG = select(inFirst, VecI32(axis[0][1]), select(inSecond, VecI32(axis[1][1]), VecI32(axis[2][1])));
+        VecI32 lowerB = select(inFirst, VecI32(axis[0][2]), select(inSecond, VecI32(axis[1][2]), VecI32(axis[2][2])));
+        VecI32 upperR = select(inFirst, VecI32(axis[1][0]), select(inSecond, VecI32(axis[2][0]), VecI32(axis[3][0])));
+        VecI32 upperG = select(inFirst, VecI32(axis[1][1]), select(inSecond, VecI32(axis[2][1]), VecI32(axis[3][1])));
+        VecI32 upperB = select(inFirst, VecI32(axis[1][2]), select(inSecond, VecI32(axis[2][2]), VecI32(axis[3][2])));
+
+        VecI32 lowerDistance = (r - lowerR) * (r - lowerR) + (g - lowerG) * (g - lowerG) + (b - lowerB) * (b - lowerB);
+        VecI32 upperDistance = (r - upperR) * (r - upperR) + (g - upperG) * (g - upperG) + (b - upperB) * (b - upperB);
+        VecI32 position = lower - (upperDistance < lowerDistance);
+
+        // Positions back to palette indices
+        VecI32 index((AXIS_POSITION_INDICES >> 0) & 0x03);
+        for (int p = 1; p < 4; ++p) {
+            index = select(position == p, VecI32((AXIS_POSITION_INDICES >> (2 * p)) & 0x03), index);
+        }
+        for (int lane = 0; lane < VecI32::LANES; ++lane) {
+            indices[k + lane] = static_cast<uint8_t>(index[lane]);
+        }
+    }
+}
+
+// Helper function to compress one 4x4 block using DXT1 algorithm
+template <bool UseBMI2>
+TCA_FLATTEN TCA_NOINLINE static void compressBlockDXT1Kernel(const uint8_t* block, uint8_t* output) {
+    // Determine a 4-color palette
+    uint8_t minR = 255, minG = 255, minB = 255;
+    uint8_t maxR = 0, maxG = 0, maxB = 0;
+
+    for (int j = 0; j < 64; j += 4) {
+        uint8_t r = block[j];
+        uint8_t g = block[j + 1];
+        uint8_t b = block[j + 2];
+
+        minR = r < minR ? r : minR;
+        minG = g < minG ? g : minG;
+        minB = b < minB ? b : minB;
+
+        maxR = r > maxR ? r : maxR;
+        maxG = g > maxG ? g : maxG;
+        maxB = b > maxB ? b : maxB;
+    }
+
+    // The maximum corner goes first: its 565 value is never smaller, and color0 > color1
+    // selects the 4-color mode
+    BC1Block encoded;
+    encoded.color0 = rgbTo565(maxR, maxG, maxB);
+    encoded.color1 = rgbTo565(minR, minG, minB);
+
+    if (encoded.color0 == encoded.color1) {
+        // Both corners quantize to the same color, which the 3-color mode decodes as index 0
+        encoded.indices = 0;
+    } else {
+        // Assign each pixel an index into the palette the decoder will rebuild
+        uint8_t palette[4][4];
+        buildPalette(getPaletteTables(), encoded.color0, encoded.color1, true, palette);
+        uint8_t indices[16];
+        selectPaletteIndexFieldsVector(block, palette, indices);
+        encoded.indices = static_cast<uint32_t>(packIndexFieldsWith<2, UseBMI2>(indices));
+    }
+
+    // Write the compressed block
+    storeBC1Block(encoded, output);
+}
+
+// Helper function to decompress one DXT1 block with the given interpolation tables. Blocks with
+// color0 <= color1 use the 3-color mode, whose index 3 is transparent black.
+template <bool UseBMI2>
+TCA_FLATTEN static inline void decompressBlockDXT1Kernel(const PaletteTables& tables, const uint8_t* input, uint8_t* block) {
+    BC1Block encoded = loadBC1Block(input);
+
+    uint8_t palette[4][4];
+    buildPalette(tables, encoded.color0, encoded.color1, encoded.color0 > encoded.color1, palette);
+
+    uint8_t indices[16];
+    unpackIndexFieldsWith<2, UseBMI2>(encoded.indices, indices);
+    for (int k = 0; k < 16; ++k) {
+        std::memcpy(block + k * 4, palette[indices[k]], 4);
+    }
+}
+
+// Helper function to encode the color half of a DXT2 block from premultiplied RGBA texels
+template <bool UseBMI2>
+TCA_FLATTEN static inline BC1Block compressColorBlockDXT2Kernel(const uint8_t* premultiplied) {
+    // Determine color palette
+    uint8_t minR = 255, minG = 255, minB = 255;
+    uint8_t maxR = 0, maxG = 0, maxB = 0;
+
+    for (int j = 0; j < 64; j += 4) {
+        uint8_t r = premultiplied[j];
+        uint8_t g = premultiplied[j + 1];
+        uint8_t b = premultiplied[j + 2];
+
+        minR = r < minR ? r : minR;
+        minG = g < minG ? g : minG;
+        minB = b < minB ? b : minB;
+
+        maxR = r > maxR ? r : maxR;
+        maxG = g > maxG ? g : maxG;
+        maxB = b > maxB ? b : maxB;
+    }
+
+    // DXT2 color blocks always decode in the 4-color mode; the maximum corner still goes first,
+    // as in DXT1, for decoders that check the order anyway
+    BC1Block encoded;
+    encoded.color0 = rgbTo565(maxR, maxG, maxB);
+    encoded.color1 = rgbTo565(minR, minG, minB);
+
+    // Assign indices
+    uint8_t palette[4][4];
+    buildPalette(getPaletteTables(), encoded.color0, encoded.color1, true, palette);
+    uint8_t indices[16];
+    selectPaletteIndexFieldsVector(premultiplied, palette, indices);
+    encoded.indices = static_cast<uint32_t>(packIndexFieldsWith<2, UseBMI2>(indices));
+    return encoded;
+}
+
+// Helper function to compress one 4x4 block using DXT2 algorithm.
+// Layout: 8 bytes of explicit 4-bit alpha followed by a color block over premultiplied RGB.
+template <bool UseBMI2>
+TCA_FLATTEN TCA_NOINLINE static void compressBlockDXT2Kernel(const uint8_t* block, uint8_t* output) {
+    // Store RGB values pre-multiplied by alpha
+    uint8_t premultiplied[64];
+    for (int j = 0; j < 64; j += 4) {
+        uint8_t alpha = block[j + 3];
+        premultiplied[j + 0] = (block[j + 0] * alpha) / 255; // Pre-multiply R
+        premultiplied[j + 1] = (block[j + 1] * alpha) / 255; // Pre-multiply G
+        premultiplied[j + 2] = (block[j + 2] * alpha) / 255; // Pre-multiply B
+        premultiplied[j + 3] = alpha; // Store alpha directly
+    }
+
+    // Alpha values, quantized to 4 bits with texel 0 in the low nibble
+    uint8_t alphas[16];
+    for (int k = 0; k < 16; ++k) {
+        alphas[k] = static_cast<uint8_t>((block[k * 4 + 3] * 15 + 127) / 255);
+    }
+    BC2Block encoded;
+    encoded.alpha = packIndexFieldsWith<4, UseBMI2>(alphas);
+
+    // Followed by the compressed color block
+    encoded.color = compressColorBlockDXT2Kernel<UseBMI2>(premultiplied);
+    storeBC2Block(encoded, output);
+}
+
+// Helper function to compress one opaque 4x4 block using DXT2 algorithm. Alpha is not read:
+// every texel is stored fully opaque, and premultiplying by 255 leaves the color unchanged.
+// Same output as compressBlockDXT2Kernel for a block whose alpha is all 255.
+template <bool UseBMI2>
+TCA_FLATTEN TCA_NOINLINE static void compressOpaqueBlockDXT2Kernel(const uint8_t* block, uint8_t* output) {
+    BC2Block encoded;
+    encoded.alpha = ~uint64_t(0);
+    encoded.color = compressColorBlockDXT2Kernel<UseBMI2>(block);
+    storeBC2Block(encoded, output);
+}
+
+// Helper function to decompress one DXT2 block with the given interpolation tables
+template <bool UseBMI2>
+TCA_FLATTEN static inline void decompressBlockDXT2Kernel(const PaletteTables& tables, const uint8_t* input, uint8_t* block) {
+    BC2Block encoded = loadBC2Block(input);
+
+    uint8_t palette[4][4];
+    buildPalette(tables, encoded.color.color0, encoded.color.color1, true, palette);
+
+    uint8_t indices[16];
+    uint8_t alphas[16];
+    unpackIndexFieldsWith<2, UseBMI2>(encoded.color.indices, indices);
+    unpackIndexFieldsWith<4, UseBMI2>(encoded.alpha, alphas);
+    for (int k = 0; k < 16; ++k) {
+        std::memcpy(block + k * 4, palette[indices[k]], 3);
+        block[k * 4 + 3] = alphas[k] * 17; // Expand 4-bit alpha to 8 bits
+    }
+}
+
+// Helper function to decompress a range of block rows with one of the block kernels above
+template <int BlockBytes, typename DecompressBlock>
+static inline void decompressBlockRowsKernel(const uint8_t* compressedData, int width, int height, int firstBlockRow, int lastBlockRow,
+                                             uint8_t* textureData, DecompressBlock decompressBlock) {
+    int blocksX = blockCount(width);
+    const PaletteTables& tables = getPaletteTables();
+    uint8_t block[64];
+
+    for (int by = firstBlockRow; by < lastBlockRow; ++by) {
+        const uint8_t* input = compressedData + static_cast<size_t>(by) * blocksX * BlockBytes;
+        for (int bx = 0; bx < blocksX; ++bx) {
+            decompressBlock(tables, input, block);
+            storeBlock(block, width, height, bx * 4, by * 4, textureData);
+            input += BlockBytes;
+        }
+    }
+}
+
+// Table entries
+
+template <bool UseBMI2>
+TCA_FLATTEN static void compressBlockDXT1Entry(const uint8_t* block, uint8_t* output) {
+    compressBlockDXT1Kernel<UseBMI2>(block, output);
+}
+
+template <bool UseBMI2>
+TCA_FLATTEN static void decompressBlockDXT1Entry(const uint8_t* input, uint8_t* block) {
+    decompressBlockDXT1Kernel<UseBMI2>(getPaletteTables(), input, block);
+}
+
+// DXT1 never reads alpha, so opaque and translucent inputs share the kernel
+template <bool UseBMI2>
+TCA_FLATTEN static void compressBlockRowsDXT1Entry(const ImageView& image, int firstBlockRow, int lastBlockRow, uint8_t* compressedData) {
+    compressBlockRows(image, firstBlockRow, lastBlockRow, DXT1_BLOCK_BYTES, compressedData, compressBlockDXT1Kernel<UseBMI2>, compressBlockDXT1Kernel<UseBMI2>);
+}
+
+template <bool UseBMI2>
+TCA_FLATTEN static void decompressBlockRowsDXT1Entry(const uint8_t* compressedData, int width, int height, int firstBlockRow, int lastBlockRow, uint8_t* textureData) {
+    decompressBlockRowsKernel<DXT1_BLOCK_BYTES>(compressedData, width, height, firstBlockRow, lastBlockRow, textureData, decompressBlockDXT1Kernel<UseBMI2>);
+}
+
+template <bool UseBMI2>
+TCA_FLATTEN static void compressBlockDXT2Entry(const uint8_t* block, uint8_t* output) {
+    compressBlockDXT2Kernel<UseBMI2>(block, output);
+}
+
+template <bool UseBMI2>
+TCA_FLATTEN static void compressOpaqueBlockDXT2Entry(const uint8_t* block, uint8_t* output) {
+    compressOpaqueBlockDXT2Kernel<UseBMI2>(block, output);
+}
+
+template <bool UseBMI2>
+TCA_FLATTEN static void decompressBlockDXT2Entry(const uint8_t* input, uint8_t* block) {
+    decompressBlockDXT2Kernel<UseBMI2>(getPaletteTables(), input, block);
+}
+
+template <bool UseBMI2>
+TCA_FLATTEN static void compressBlockRowsDXT2Entry(const ImageView& image, int firstBlockRow, int lastBlockRow, uint8_t* compressedData) {
+    compressBlockRows(image, firstBlockRow, lastBlockRow, DXT2_BLOCK_BYTES, compressedData, compressBlockDXT2Kernel<UseBMI2>, compressOpaqueBlockDXT2Kernel<UseBMI2>);
+}
+
+template <bool UseBMI2>
+TCA_FLATTEN static void decompressBlockRowsDXT2Entry(const uint8_t* compressedData, int width, int height, int firstBlockRow, int lastBlockRow, uint8_t* textureData) {
+    decompressBlockRowsKernel<DXT2_BLOCK_BYTES>(compressedData, width, height, firstBlockRow, lastBlockRow, textureData, decompressBlockDXT2Kernel<UseBMI2>);
+}
+
+template <bool UseBMI2>
+TCA_FLATTEN static uint32_t selectPaletteIndicesEntry(const uint8_t* block, const uint8_t palette[4][4]) {
+    uint8_t indices[16];
+    selectPaletteIndexFieldsVector(block, palette, indices);
+    return static_cast<uint32_t>(packIndexFieldsWith<2, UseBMI2>(indices));
+}
+
+// Helper function to get the table of one index packing
+template <bool UseBMI2>
+static const DXTKernels& getKernelTable() {
+    static const DXTKernels kernels = {
+        SimdIsa::DXT_KERNELS_ISA,
+        UseBMI2,
+        compressBlockDXT1Entry<UseBMI2>, decompressBlockDXT1Entry<UseBMI2>, compressBlockRowsDXT1Entry<UseBMI2>, decompressBlockRowsDXT1Entry<UseBMI2>,
+        compressBlockDXT2Entry<UseBMI2>, compressOpaqueBlockDXT2Entry<UseBMI2>, decompressBlockDXT2Entry<UseBMI2>,
+        compressBlockRowsDXT2Entry<UseBMI2>, decompressBlockRowsDXT2Entry<UseBMI2>,
+        selectPaletteIndicesEntry<UseBMI2>,
+    };
+    return kernels;
+}
+
+const DXTKernels& DXT_KERNELS_TABLE(DXT_KERNELS_ISA)() {
+#if TCA_SIMD_BMI2
+    // AMD before Zen 3 has BMI2 but microcodes pdep/pext; the vector kernels still pay off there
+    if (getCpuFeatures().fastPdep) {
+        return getKernelTable<true>();
+    }
+#endif
+    return getKernelTable<false>();
+}
@@ -0,0 +1,6 @@
+// DXT kernels built for AVX2 and BMI2 (flags set in CMakeLists.txt)
+#if !defined(__AVX2__) || !defined(__BMI2__)
+#error "dxt_kernels_avx2.cpp must be compiled with -mavx2 -mbmi2"
+#endif
+#define DXT_KERNELS_ISA AVX2
+#include "dxt_kernels.inl"
@@ -0,0 +1,6 @@
+// DXT kernels built for AVX-512 F/BW/VL and BMI2 (flags set in CMakeLists.txt)
+#if !defined(__AVX512F__) || !defined(__AVX512BW__) || !defined(__AVX512VL__) || !defined(__BMI2__)
+#error "dxt_kernels_avx512.cpp must be compiled with -mavx512f -mavx512bw -mavx512vl -mbmi2"
+#endif
+#define DXT_KERNELS_ISA AVX512
+#include "dxt_kernels.inl"
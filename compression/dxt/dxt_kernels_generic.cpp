@@ -0,0 +1,3 @@
+// DXT kernels built with the baseline flags of the build
+#define DXT_KERNELS_ISA Generic
+#include "dxt_kernels.inl"
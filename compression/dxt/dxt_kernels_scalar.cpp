@@ -0,0 +1,5 @@
+// Reference DXT kernels: one texel at a time with portable index packing, built without
+// auto-vectorization (see CMakeLists.txt). TextureBenchmark --verify checks the others against it.
+#define TCA_SIMD_SCALAR
+#define DXT_KERNELS_ISA Scalar
+#include "dxt_kernels.inl"
@@ -0,0 +1,183 @@
+#include <cstring>
+#include "../../include/dxt/dxt_reference.h"
+#include "../../include/dxt/color_utils.h"
+#include "../../include/dxt/dxt.h"
+
+// Helper function to get the block size of a format
+static int referenceBlockBytes(CompressionAlgorithm algorithm) {
+    return algorithm == CompressionAlgorithm::DXT1 ? DXT1_BLOCK_BYTES : DXT2_BLOCK_BYTES;
+}
+
+// Helper function to write the low bytes of a value in little-endian order
+static void storeLittleEndian(uint64_t value, int bytes, uint8_t* output) {
+    for (int i = 0; i < bytes; ++i) {
+        output[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+// Helper function to read a little-endian value of the given number of bytes
+static uint64_t loadLittleEndian(const uint8_t* input, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(input[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Helper function to read texel (x, y) of an image as RGBA; texels outside it are opaque black
+static void readTexel(const ImageView& image, int x, int y, uint8_t* rgba) {
+    if (x >= image.width || y >= image.height) {
+        rgba[0] = rgba[1] = rgba[2] = 0;
+        rgba[3] = 255;
+        return;
+    }
+    const uint8_t* source = image.data + static_cast<size_t>(y) * image.stride + static_cast<size_t>(x) * image.channels;
+    switch (image.channels) {
+        case 1:
+            rgba[0] = rgba[1] = rgba[2] = source[0];
+            rgba[3] = 255;
+            break;
+        case 2:
+            rgba[0] = rgba[1] = rgba[2] = source[0];
+            rgba[3] = source[1];
+            break;
+        case 3:
+            std::memcpy(rgba, source, 3);
+            rgba[3] = 255;
+            break;
+        default:
+            std::memcpy(rgba, source, 4);
+            break;
+    }
+}
+
+// Helper function to build the palette of a color block one channel at a time. In the 4-color
+// mode entries 2 and 3 lie at 1/3 and 2/3 between the endpoints; in the 3-color mode entry 2 is
+// the midpoint and entry 3 transparent black.
+static void buildReferencePalette(uint16_t color0, uint16_t color1, bool fourColor, uint8_t palette[4][4]) {
+    const PaletteTables& tables = getPaletteTables();
+    const int shifts[3] = {11, 5, 0};
+    for (int c = 0; c < 3; ++c) {
+        bool green = c == 1;
+        int mask = green ? 0x3F : 0x1F;
+        int a = (color0 >> shifts[c]) & mask;
+        int b = (color1 >> shifts[c]) & mask;
+        palette[0][c] = green ? EXPAND6.values[a] : EXPAND5.values[a];
+        palette[1][c] = green ? EXPAND6.values[b] : EXPAND5.values[b];
+        if (fourColor) {
+            palette[2][c] = green ? tables.third6[a][b] : tables.third5[a][b];
+            palette[3][c] = green ? tables.third6[b][a] : tables.third5[b][a];
+        } else {
+            palette[2][c] = green ? tables.half6[a][b] : tables.half5[a][b];
+            palette[3][c] = 0;
+        }
+    }
+    palette[0][3] = 255;
+    palette[1][3] = 255;
+    palette[2][3] = 255;
+    palette[3][3] = fourColor ? 255 : 0;
+}
+
+// Helper function to encode the color block of 16 RGBA texels into 8 bytes. DXT1 encodes a block
+// whose corners quantize to one color with all indices 0; DXT2 always selects indices.
+static void compressColorBlockReference(const uint8_t* texels, bool solidShortcut, uint8_t* output) {
+    int minimum[3] = {255, 255, 255};
+    int maximum[3] = {0, 0, 0};
+    for (int k = 0; k < 16; ++k) {
+        for (int c = 0; c < 3; ++c) {
+            int value = texels[k * 4 + c];
+            minimum[c] = value < minimum[c] ? value : minimum[c];
+            maximum[c] = value > maximum[c] ? value : maximum[c];
+        }
+    }
+    uint16_t color0 = rgbTo565(static_cast<uint8_t>(maximum[0]), static_cast<uint8_t>(maximum[1]), static_cast<uint8_t>(maximum[2]));
+    uint16_t color1 = rgbTo565(static_cast<uint8_t>(minimum[0]), static_cast<uint8_t>(minimum[1]), static_cast<uint8_t>(minimum[2]));
+
+    uint32_t indices = 0;
+    if (!(solidShortcut && color0 == color1)) {
+        uint8_t palette[4][4];
+        buildReferencePalette(color0, color1, true, palette);
+        uint8_t fields[16];
+        selectPaletteIndexFields(texels, palette, fields);
+        for (int k = 0; k < 16; ++k) {
+            indices |= static_cast<uint32_t>(fields[k]) << (2 * k);
+        }
+    }
+
+    storeLittleEndian(color0, 2, output);
+    storeLittleEndian(color1, 2, output + 2);
+    storeLittleEndian(indices, 4, output + 4);
+}
+
+void compressBlockReference(CompressionAlgorithm algorithm, const uint8_t* block, uint8_t* output) {
+    if (algorithm == CompressionAlgorithm::DXT1) {
+        compressColorBlockReference(block, true, output);
+        return;
+    }
+
+    // DXT2: 4-bit alpha per texel, then a color block over the premultiplied texels
+    uint8_t premultiplied[64];
+    uint64_t alpha = 0;
+    for (int k = 0; k < 16; ++k) {
+        int a = block[k * 4 + 3];
+        for (int c = 0; c < 3; ++c) {
+            premultiplied[k * 4 + c] = static_cast<uint8_t>(block[k * 4 + c] * a / 255);
+        }
+        premultiplied[k * 4 + 3] = static_cast<uint8_t>(a);
+        alpha |= static_cast<uint64_t>((a * 15 + 127) / 255) << (4 * k);
+    }
+    storeLittleEndian(alpha, 8, output);
+    compressColorBlockReference(premultiplied, false, output + 8);
+}
+
+void decompressBlockReference(CompressionAlgorithm algorithm, const uint8_t* input, uint8_t* block) {
+    const uint8_t* color = algorithm == CompressionAlgorithm::DXT1 ? input : input + 8;
+    uint16_t color0 = static_cast<uint16_t>(loadLittleEndian(color, 2));
+    uint16_t color1 = static_cast<uint16_t>(loadLittleEndian(color + 2, 2));
+    uint32_t indices = static_cast<uint32_t>(loadLittleEndian(color + 4, 4));
+
+    // DXT2 color blocks always decode in the 4-color mode
+    uint8_t palette[4][4];
+    buildReferencePalette(color0, color1, algorithm != CompressionAlgorithm::DXT1 || color0 > color1, palette);
+
+    uint64_t alpha = algorithm == CompressionAlgorithm::DXT1 ? 0 : loadLittleEndian(input, 8);
+    for (int k = 0; k < 16; ++k) {
+        const uint8_t* entry = palette[(indices >> (2 * k)) & 0x03];
+        block[k * 4 + 0] = entry[0];
+        block[k * 4 + 1] = entry[1];
+        block[k * 4 + 2] = entry[2];
+        block[k * 4 + 3] = algorithm == CompressionAlgorithm::DXT1 ? entry[3] : static_cast<uint8_t>(((alpha >> (4 * k)) & 0x0F) * 17);
+    }
+}
+
+void compressImageReference(CompressionAlgorithm algorithm, const ImageView& image, uint8_t* compressedData) {
+    int blockBytes = referenceBlockBytes(algorithm);
+    uint8_t block[64];
+    for (int by = 0; by * 4 < image.height; ++by) {
+        for (int bx = 0; bx * 4 < image.width; ++bx) {
+            for (int k = 0; k < 16; ++k) {
+                readTexel(image, bx * 4 + k % 4, by * 4 + k / 4, block + k * 4);
+            }
+            compressBlockReference(algorithm, block, compressedData);
+            compressedData += blockBytes;
+        }
+    }
+}
+
+void decompressImageReference(CompressionAlgorithm algorithm, const uint8_t* compressedData, int width, int height, uint8_t* textureData) {
+    int blockBytes = referenceBlockBytes(algorithm);
+    uint8_t block[64];
+    for (int by = 0; by * 4 < height; ++by) {
+        for (int bx = 0; bx * 4 < width; ++bx) {
+            decompressBlockReference(algorithm, compressedData, block);
+            compressedData += blockBytes;
+            for (int k = 0; k < 16; ++k) {
+                int x = bx * 4 + k % 4;
+                int y = by * 4 + k / 4;
+                if (x < width && y < height) {
+                    std::memcpy(textureData + (static_cast<size_t>(y) * width + x) * 4, block + k * 4, 4);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include <cstring>
+#include "../include/compression/sequence_encoder.h"
+#include "../include/dxt/block_io.h"
+#include "../include/analytics/trace.h"
+
+// Helper function to check that no channel of two blocks differs by more than maxError
+static bool blockWithinError(const uint8_t* block, const uint8_t* reference, int maxError) {
+    for (int i = 0; i < 64; ++i) {
+        if (std::abs(static_cast<int>(block[i]) - static_cast<int>(reference[i])) > maxError) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SequenceEncoder::SequenceEncoder(const BlockCodec& codec, int width, int height, int maxBlockError)
+    : codec_(codec), width_(width), height_(height), maxBlockError_(maxBlockError),
+      referenceBlocks_(static_cast<size_t>(blockCount(width)) * blockCount(height) * 64),
+      encodedFrame_(getCompressedSize(codec, width, height)) {}
+
+SequenceFrameStats SequenceEncoder::encodeFrame(const ImageView& frame, std::vector<uint8_t>& compressedData,
+                                                BlockDedupeCache* dedupeCache) {
+    TRACE_SCOPE("SequenceEncoder::encodeFrame");
+    SequenceFrameStats stats;
+    int blocksX = blockCount(width_);
+    int blocksY = blockCount(height_);
+    uint8_t block[64];
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            size_t index = static_cast<size_t>(by) * blocksX + bx;
+            uint8_t* reference = &referenceBlocks_[index * 64];
+            uint8_t* encoded = &encodedFrame_[index * codec_.blockBytes];
+            extractBlock(frame, bx * 4, by * 4, block);
+            ++stats.blocks;
+
+            if (hasReference_) {
+                if (std::memcmp(block, reference, 64) == 0) {
+                    ++stats.reusedExact;
+                    continue;
+                }
+                if (maxBlockError_ > 0 && blockWithinError(block, reference, maxBlockError_)) {
+                    ++stats.reusedWithinError;
+                    continue;
+                }
+            }
+
+            if (dedupeCache) {
+                dedupeCache->compressBlock(codec_, block, encoded);
+            } else {
+                codec_.compressBlock(block, encoded);
+            }
+            std::memcpy(reference, block, 64);
+            ++stats.encoded;
+        }
+    }
+    hasReference_ = true;
+    compressedData = encodedFrame_;
+    return stats;
+}
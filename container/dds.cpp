@@ -0,0 +1,283 @@
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "../include/container/byte_order.h"
+#include "../include/container/dds.h"
+#include "../include/container/surface_layout.h"
+#include "../include/analytics/trace.h"
+#include "../include/logging/logger.h"
+
+// Header sizes, and byte offsets of the fields used here counted from the start of the file (magic included)
+static const size_t DDS_MAGIC_BYTES = 4;
+static const size_t DDS_HEADER_BYTES = 124;
+static const size_t DDS_DX10_HEADER_BYTES = 20;
+static const size_t OFFSET_SIZE = 4;
+static const size_t OFFSET_FLAGS = 8;
+static const size_t OFFSET_HEIGHT = 12;
+static const size_t OFFSET_WIDTH = 16;
+static const size_t OFFSET_LINEAR_SIZE = 20;
+static const size_t OFFSET_MIP_COUNT = 28;
+static const size_t OFFSET_PIXEL_FORMAT_SIZE = 76;
+static const size_t OFFSET_PIXEL_FORMAT_FLAGS = 80;
+static const size_t OFFSET_FOURCC = 84;
+static const size_t OFFSET_CAPS = 108;
+static const size_t OFFSET_CAPS2 = 112;
+static const size_t OFFSET_DXGI_FORMAT = 128;
+static const size_t OFFSET_RESOURCE_DIMENSION = 132;
+static const size_t OFFSET_MISC_FLAG = 136;
+static const size_t OFFSET_ARRAY_SIZE = 140;
+static const size_t OFFSET_MISC_FLAGS2 = 144;
+
+// Header flag values from the DDS specification
+static const uint32_t DDSD_REQUIRED = 0x1 | 0x2 | 0x4 | 0x1000; // CAPS | HEIGHT | WIDTH | PIXELFORMAT
+static const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+static const uint32_t DDSD_LINEARSIZE = 0x80000;
+static const uint32_t DDPF_FOURCC = 0x4;
+static const uint32_t DDSCAPS_COMPLEX = 0x8;
+static const uint32_t DDSCAPS_TEXTURE = 0x1000;
+static const uint32_t DDSCAPS_MIPMAP = 0x400000;
+static const uint32_t DDSCAPS2_CUBEMAP_ALL_FACES = 0x200 | 0xFC00;
+static const uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+static const uint32_t D3D10_RESOURCE_MISC_TEXTURECUBE = 0x4;
+static const uint32_t DDS_ALPHA_MODE_STRAIGHT = 1;
+static const uint32_t DDS_ALPHA_MODE_PREMULTIPLIED = 2;
+
+// DXGI formats of the BC family
+static const uint32_t DXGI_FORMAT_BC1_UNORM = 71;
+static const uint32_t DXGI_FORMAT_BC2_UNORM = 74;
+static const uint32_t DXGI_FORMAT_BC3_UNORM = 77;
+static const uint32_t DXGI_FORMAT_BC4_UNORM = 80;
+static const uint32_t DXGI_FORMAT_BC5_UNORM = 83;
+static const uint32_t DXGI_FORMAT_BC6H_UF16 = 95;
+static const uint32_t DXGI_FORMAT_BC7_UNORM = 98;
+
+static uint32_t makeFourCC(const char* code) {
+    return static_cast<uint32_t>(code[0]) | (static_cast<uint32_t>(code[1]) << 8) |
+           (static_cast<uint32_t>(code[2]) << 16) | (static_cast<uint32_t>(code[3]) << 24);
+}
+
+// Function to get the legacy FourCC of a format, or 0 if it needs the DX10 header
+static uint32_t getLegacyFourCC(CompressionAlgorithm algorithm) {
+    switch (algorithm) {
+        case CompressionAlgorithm::DXT1:
+        case CompressionAlgorithm::BC1: return makeFourCC("DXT1");
+        case CompressionAlgorithm::DXT2: return makeFourCC("DXT2");
+        case CompressionAlgorithm::DXT3:
+        case CompressionAlgorithm::BC2: return makeFourCC("DXT3");
+        case CompressionAlgorithm::DXT4: return makeFourCC("DXT4");
+        case CompressionAlgorithm::DXT5:
+        case CompressionAlgorithm::BC3: return makeFourCC("DXT5");
+        case CompressionAlgorithm::BC4: return makeFourCC("ATI1");
+        case CompressionAlgorithm::BC5: return makeFourCC("ATI2");
+        default: return 0;
+    }
+}
+
+// Function to get the DXGI format of a format, or 0 if it has none
+static uint32_t getDXGIFormat(CompressionAlgorithm algorithm) {
+    switch (algorithm) {
+        case CompressionAlgorithm::DXT1:
+        case CompressionAlgorithm::BC1: return DXGI_FORMAT_BC1_UNORM;
+        case CompressionAlgorithm::DXT2:
+        case CompressionAlgorithm::DXT3:
+        case CompressionAlgorithm::BC2: return DXGI_FORMAT_BC2_UNORM;
+        case CompressionAlgorithm::DXT4:
+        case CompressionAlgorithm::DXT5:
+        case CompressionAlgorithm::BC3: return DXGI_FORMAT_BC3_UNORM;
+        case CompressionAlgorithm::BC4: return DXGI_FORMAT_BC4_UNORM;
+        case CompressionAlgorithm::BC5: return DXGI_FORMAT_BC5_UNORM;
+        case CompressionAlgorithm::BC6H: return DXGI_FORMAT_BC6H_UF16;
+        case CompressionAlgorithm::BC7: return DXGI_FORMAT_BC7_UNORM;
+        default: return 0;
+    }
+}
+
+// Function to map a legacy FourCC back to a format
+static bool parseLegacyFourCC(uint32_t fourCC, CompressionAlgorithm& algorithm) {
+    static const struct { const char* code; CompressionAlgorithm algorithm; } formats[] = {
+        {"DXT1", CompressionAlgorithm::DXT1}, {"DXT2", CompressionAlgorithm::DXT2}, {"DXT3", CompressionAlgorithm::DXT3},
+        {"DXT4", CompressionAlgorithm::DXT4}, {"DXT5", CompressionAlgorithm::DXT5}, {"ATI1", CompressionAlgorithm::BC4},
+        {"BC4U", CompressionAlgorithm::BC4},  {"ATI2", CompressionAlgorithm::BC5},  {"BC5U", CompressionAlgorithm::BC5},
+    };
+    for (const auto& format : formats) {
+        if (fourCC == makeFourCC(format.code)) {
+            algorithm = format.algorithm;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to map a DXGI format and alpha mode back to a format
+static bool parseDXGIFormat(uint32_t dxgiFormat, bool premultiplied, CompressionAlgorithm& algorithm) {
+    switch (dxgiFormat) {
+        case DXGI_FORMAT_BC1_UNORM: algorithm = CompressionAlgorithm::DXT1; return true;
+        case DXGI_FORMAT_BC2_UNORM: algorithm = premultiplied ? CompressionAlgorithm::DXT2 : CompressionAlgorithm::DXT3; return true;
+        case DXGI_FORMAT_BC3_UNORM: algorithm = premultiplied ? CompressionAlgorithm::DXT4 : CompressionAlgorithm::DXT5; return true;
+        case DXGI_FORMAT_BC4_UNORM: algorithm = CompressionAlgorithm::BC4; return true;
+        case DXGI_FORMAT_BC5_UNORM: algorithm = CompressionAlgorithm::BC5; return true;
+        case DXGI_FORMAT_BC6H_UF16: algorithm = CompressionAlgorithm::BC6H; return true;
+        case DXGI_FORMAT_BC7_UNORM: algorithm = CompressionAlgorithm::BC7; return true;
+        default: return false;
+    }
+}
+
+static bool isPremultiplied(CompressionAlgorithm algorithm) {
+    return algorithm == CompressionAlgorithm::DXT2 || algorithm == CompressionAlgorithm::DXT4;
+}
+
+bool isDDSDescriptionValid(const DDSDescription& description) {
+    if (getFormatBlockBytes(description.algorithm) == 0 || description.width <= 0 || description.height <= 0 ||
+        description.arraySize < 1 || description.arraySize > MAX_TEXTURE_LAYERS || !isValidMipCount(description.width, description.height, description.mipLevels)) {
+        return false;
+    }
+    if (description.cubeMap && description.width != description.height) {
+        return false;
+    }
+    if (description.dx10Header) {
+        return getDXGIFormat(description.algorithm) != 0;
+    }
+    // Legacy headers have no array size; a single cube map is expressed through caps2
+    return getLegacyFourCC(description.algorithm) != 0 && description.arraySize == 1;
+}
+
+size_t getDDSPayloadBytes(const DDSDescription& description) {
+    size_t chainBytes = 0;
+    for (int mip = 0; mip < description.mipLevels; ++mip) {
+        chainBytes += getMipSurfaceBytes(description.algorithm, description.width, description.height, mip);
+    }
+    return multiplySizes(chainBytes, static_cast<size_t>(description.surfaceCount()));
+}
+
+bool writeDDS(const std::string& filePath, const DDSDescription& description, const uint8_t* payload, size_t payloadBytes) {
+    TRACE_SCOPE("writeDDS");
+    if (!isDDSDescriptionValid(description)) {
+        LOG_ERROR("Cannot describe " << getAlgorithmName(description.algorithm) << " " << description.width << "x" << description.height
+                  << " with " << description.mipLevels << " mips and " << description.arraySize << " layers in a "
+                  << (description.dx10Header ? "DX10" : "legacy") << " DDS header: " << filePath);
+        return false;
+    }
+    if (payloadBytes != getDDSPayloadBytes(description)) {
+        LOG_ERROR("DDS payload is " << payloadBytes << " bytes, expected " << getDDSPayloadBytes(description) << ": " << filePath);
+        return false;
+    }
+
+    uint8_t header[DDS_MAGIC_BYTES + DDS_HEADER_BYTES + DDS_DX10_HEADER_BYTES];
+    std::memset(header, 0, sizeof(header));
+    std::memcpy(header, "DDS ", 4);
+    bool hasMips = description.mipLevels > 1;
+    putU32(header, OFFSET_SIZE, static_cast<uint32_t>(DDS_HEADER_BYTES));
+    putU32(header, OFFSET_FLAGS, DDSD_REQUIRED | DDSD_LINEARSIZE | (hasMips ? DDSD_MIPMAPCOUNT : 0));
+    putU32(header, OFFSET_HEIGHT, static_cast<uint32_t>(description.height));
+    putU32(header, OFFSET_WIDTH, static_cast<uint32_t>(description.width));
+    putU32(header, OFFSET_LINEAR_SIZE, static_cast<uint32_t>(getMipSurfaceBytes(description.algorithm, description.width, description.height, 0)));
+    putU32(header, OFFSET_MIP_COUNT, static_cast<uint32_t>(description.mipLevels));
+    putU32(header, OFFSET_PIXEL_FORMAT_SIZE, 32);
+    putU32(header, OFFSET_PIXEL_FORMAT_FLAGS, DDPF_FOURCC);
+    putU32(header, OFFSET_FOURCC, description.dx10Header ? makeFourCC("DX10") : getLegacyFourCC(description.algorithm));
+    bool complex = hasMips || description.cubeMap || description.arraySize > 1;
+    putU32(header, OFFSET_CAPS, DDSCAPS_TEXTURE | (complex ? DDSCAPS_COMPLEX : 0) | (hasMips ? DDSCAPS_MIPMAP : 0));
+    putU32(header, OFFSET_CAPS2, description.cubeMap ? DDSCAPS2_CUBEMAP_ALL_FACES : 0);
+
+    size_t headerBytes = DDS_MAGIC_BYTES + DDS_HEADER_BYTES;
+    if (description.dx10Header) {
+        putU32(header, OFFSET_DXGI_FORMAT, getDXGIFormat(description.algorithm));
+        putU32(header, OFFSET_RESOURCE_DIMENSION, D3D10_RESOURCE_DIMENSION_TEXTURE2D);
+        putU32(header, OFFSET_MISC_FLAG, description.cubeMap ? D3D10_RESOURCE_MISC_TEXTURECUBE : 0);
+        putU32(header, OFFSET_ARRAY_SIZE, static_cast<uint32_t>(description.arraySize));
+        putU32(header, OFFSET_MISC_FLAGS2, isPremultiplied(description.algorithm) ? DDS_ALPHA_MODE_PREMULTIPLIED : DDS_ALPHA_MODE_STRAIGHT);
+        headerBytes += DDS_DX10_HEADER_BYTES;
+    }
+
+    std::ofstream outFile(filePath, std::ios::binary);
+    if (!outFile) {
+        LOG_ERROR("Failed to open file for writing: " << filePath);
+        return false;
+    }
+    outFile.write(reinterpret_cast<const char*>(header), headerBytes);
+    outFile.write(reinterpret_cast<const char*>(payload), payloadBytes);
+    if (!outFile) {
+        LOG_ERROR("Failed to write DDS file: " << filePath);
+        return false;
+    }
+    return true;
+}
+
+bool DDSFile::open(const std::string& filePath) {
+    TRACE_SCOPE("DDSFile::open");
+    description_ = DDSDescription();
+    if (!file_.open(filePath)) {
+        return false;
+    }
+
+    const uint8_t* bytes = file_.data();
+    size_t size = file_.size();
+    if (size < DDS_MAGIC_BYTES + DDS_HEADER_BYTES || std::memcmp(bytes, "DDS ", 4) != 0 ||
+        getU32(bytes, OFFSET_SIZE) != DDS_HEADER_BYTES || getU32(bytes, OFFSET_PIXEL_FORMAT_SIZE) != 32) {
+        LOG_ERROR("Not a DDS file: " << filePath);
+        file_.close();
+        return false;
+    }
+
+    DDSDescription description;
+    uint32_t width = getU32(bytes, OFFSET_WIDTH);
+    uint32_t height = getU32(bytes, OFFSET_HEIGHT);
+    if (width > MAX_TEXTURE_DIMENSION || height > MAX_TEXTURE_DIMENSION) {
+        LOG_ERROR("DDS dimensions " << width << "x" << height << " exceed " << MAX_TEXTURE_DIMENSION << ": " << filePath);
+        file_.close();
+        return false;
+    }
+    description.width = static_cast<int>(width);
+    description.height = static_cast<int>(height);
+    uint32_t mipCount = getU32(bytes, OFFSET_MIP_COUNT);
+    description.mipLevels = mipCount > 0 ? static_cast<int>(mipCount) : 1; // Some writers omit DDSD_MIPMAPCOUNT
+
+    bool formatKnown = false;
+    uint32_t fourCC = getU32(bytes, OFFSET_FOURCC);
+    if (!(getU32(bytes, OFFSET_PIXEL_FORMAT_FLAGS) & DDPF_FOURCC)) {
+        // Uncompressed pixel formats are not block data
+    } else if (fourCC == makeFourCC("DX10")) {
+        if (size < DDS_MAGIC_BYTES + DDS_HEADER_BYTES + DDS_DX10_HEADER_BYTES ||
+            getU32(bytes, OFFSET_RESOURCE_DIMENSION) != D3D10_RESOURCE_DIMENSION_TEXTURE2D) {
+            LOG_ERROR("Unsupported DX10 DDS resource: " << filePath);
+            file_.close();
+            return false;
+        }
+        description.dx10Header = true;
+        description.cubeMap = (getU32(bytes, OFFSET_MISC_FLAG) & D3D10_RESOURCE_MISC_TEXTURECUBE) != 0;
+        uint32_t arraySize = getU32(bytes, OFFSET_ARRAY_SIZE);
+        description.arraySize = arraySize > MAX_TEXTURE_LAYERS ? 0 : static_cast<int>(arraySize); // 0 fails validation
+        bool premultiplied = (getU32(bytes, OFFSET_MISC_FLAGS2) & 0x7) == DDS_ALPHA_MODE_PREMULTIPLIED;
+        formatKnown = parseDXGIFormat(getU32(bytes, OFFSET_DXGI_FORMAT), premultiplied, description.algorithm);
+    } else {
+        description.cubeMap = (getU32(bytes, OFFSET_CAPS2) & DDSCAPS2_CUBEMAP_ALL_FACES) == DDSCAPS2_CUBEMAP_ALL_FACES;
+        formatKnown = parseLegacyFourCC(fourCC, description.algorithm);
+    }
+    if (!formatKnown || !isDDSDescriptionValid(description)) {
+        LOG_ERROR("Unsupported DDS format or layout: " << filePath);
+        file_.close();
+        return false;
+    }
+
+    payloadOffset_ = DDS_MAGIC_BYTES + DDS_HEADER_BYTES + (description.dx10Header ? DDS_DX10_HEADER_BYTES : 0);
+    if (size - payloadOffset_ < getDDSPayloadBytes(description)) {
+        LOG_ERROR("DDS file is truncated: " << filePath);
+        file_.close();
+        return false;
+    }
+    description_ = description;
+    return true;
+}
+
+const uint8_t* DDSFile::surface(int surfaceIndex, int mipLevel, size_t& bytes) const {
+    bytes = 0;
+    if (!file_.isOpen() || surfaceIndex < 0 || surfaceIndex >= description_.surfaceCount() || mipLevel < 0 || mipLevel >= description_.mipLevels) {
+        return nullptr;
+    }
+    size_t offset = payloadOffset_ + getDDSPayloadBytes(description_) / description_.surfaceCount() * surfaceIndex;
+    for (int mip = 0; mip < mipLevel; ++mip) {
+        offset += getMipSurfaceBytes(description_.algorithm, description_.width, description_.height, mip);
+    }
+    bytes = getMipSurfaceBytes(description_.algorithm, description_.width, description_.height, mipLevel);
+    return file_.data() + offset;
+}
@@ -0,0 +1,375 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include "../include/container/byte_order.h"
+#include "../include/container/ktx2.h"
+#include "../include/container/lz_block.h"
+#include "../include/container/surface_layout.h"
+#include "../include/encoder_version.h"
+#include "../include/thread_ranges.h"
+#include "../include/analytics/trace.h"
+#include "../include/logging/logger.h"
+
+static const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+// Sizes of the fixed parts of the file and byte offsets of the header fields
+static const size_t HEADER_BYTES = 80;
+static const size_t LEVEL_ENTRY_BYTES = 24;
+static const size_t OFFSET_VK_FORMAT = 12;
+static const size_t OFFSET_TYPE_SIZE = 16;
+static const size_t OFFSET_PIXEL_WIDTH = 20;
+static const size_t OFFSET_PIXEL_HEIGHT = 24;
+static const size_t OFFSET_PIXEL_DEPTH = 28;
+static const size_t OFFSET_LAYER_COUNT = 32;
+static const size_t OFFSET_FACE_COUNT = 36;
+static const size_t OFFSET_LEVEL_COUNT = 40;
+static const size_t OFFSET_SUPERCOMPRESSION = 44;
+static const size_t OFFSET_DFD_OFFSET = 48;
+static const size_t OFFSET_DFD_LENGTH = 52;
+static const size_t OFFSET_KVD_OFFSET = 56;
+static const size_t OFFSET_KVD_LENGTH = 60;
+
+// Vulkan formats of the BC family (UNORM; the sRGB variants are accepted when reading)
+static const uint32_t VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131;
+static const uint32_t VK_FORMAT_BC1_RGBA_UNORM_BLOCK = 133;
+static const uint32_t VK_FORMAT_BC2_UNORM_BLOCK = 135;
+static const uint32_t VK_FORMAT_BC3_UNORM_BLOCK = 137;
+static const uint32_t VK_FORMAT_BC4_UNORM_BLOCK = 139;
+static const uint32_t VK_FORMAT_BC5_UNORM_BLOCK = 141;
+static const uint32_t VK_FORMAT_BC6H_UFLOAT_BLOCK = 143;
+static const uint32_t VK_FORMAT_BC7_UNORM_BLOCK = 145;
+
+// Data format descriptor values (Khronos Data Format Specification)
+static const uint32_t KHR_DF_MODEL_BC1A = 128;
+static const uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+static const uint32_t KHR_DF_TRANSFER_LINEAR = 1;
+static const uint32_t KHR_DF_FLAG_ALPHA_PREMULTIPLIED = 1;
+static const uint32_t KHR_DF_SAMPLE_DATATYPE_FLOAT = 0x80;
+static const uint32_t KHR_DF_CHANNEL_BC1A_ALPHAPRESENT = 1;
+static const uint32_t KHR_DF_CHANNEL_BC2_ALPHA = 15;
+
+static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool isPremultiplied(CompressionAlgorithm algorithm) {
+    return algorithm == CompressionAlgorithm::DXT2 || algorithm == CompressionAlgorithm::DXT4;
+}
+
+// Function to get the Vulkan format of a block format, or 0 if it has none
+static uint32_t getVkFormat(CompressionAlgorithm algorithm) {
+    switch (algorithm) {
+        case CompressionAlgorithm::DXT1:
+        case CompressionAlgorithm::BC1: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case CompressionAlgorithm::DXT2:
+        case CompressionAlgorithm::DXT3:
+        case CompressionAlgorithm::BC2: return VK_FORMAT_BC2_UNORM_BLOCK;
+        case CompressionAlgorithm::DXT4:
+        case CompressionAlgorithm::DXT5:
+        case CompressionAlgorithm::BC3: return VK_FORMAT_BC3_UNORM_BLOCK;
+        case CompressionAlgorithm::BC4: return VK_FORMAT_BC4_UNORM_BLOCK;
+        case CompressionAlgorithm::BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+        case CompressionAlgorithm::BC6H: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+        case CompressionAlgorithm::BC7: return VK_FORMAT_BC7_UNORM_BLOCK;
+        default: return 0;
+    }
+}
+
+// Function to map a Vulkan format (UNORM or sRGB) and the premultiplied flag back to a block format
+static bool parseVkFormat(uint32_t vkFormat, bool premultiplied, CompressionAlgorithm& algorithm) {
+    switch (vkFormat) {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK + 1:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK + 1: algorithm = CompressionAlgorithm::DXT1; return true;
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_UNORM_BLOCK + 1: algorithm = premultiplied ? CompressionAlgorithm::DXT2 : CompressionAlgorithm::DXT3; return true;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK + 1: algorithm = premultiplied ? CompressionAlgorithm::DXT4 : CompressionAlgorithm::DXT5; return true;
+        case VK_FORMAT_BC4_UNORM_BLOCK: algorithm = CompressionAlgorithm::BC4; return true;
+        case VK_FORMAT_BC5_UNORM_BLOCK: algorithm = CompressionAlgorithm::BC5; return true;
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK: algorithm = CompressionAlgorithm::BC6H; return true;
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK + 1: algorithm = CompressionAlgorithm::BC7; return true;
+        default: return false;
+    }
+}
+
+// One sample of the data format descriptor: a bit range of the block and what it holds
+struct DescriptorSample {
+    uint32_t bitOffset;
+    uint32_t bitLength;
+    uint32_t channelType;
+};
+
+// Function to build the basic data format descriptor of a block format
+static std::vector<uint8_t> buildDataFormatDescriptor(CompressionAlgorithm algorithm) {
+    uint32_t vkFormat = getVkFormat(algorithm);
+    uint32_t colorModel = KHR_DF_MODEL_BC1A + (vkFormat - VK_FORMAT_BC1_RGBA_UNORM_BLOCK) / 2;
+    int blockBytes = getFormatBlockBytes(algorithm);
+
+    std::vector<DescriptorSample> samples;
+    switch (vkFormat) {
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            samples.push_back({0, 64, KHR_DF_CHANNEL_BC1A_ALPHAPRESENT});
+            break;
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+            samples.push_back({0, 64, KHR_DF_CHANNEL_BC2_ALPHA});
+            samples.push_back({64, 64, 0});
+            break;
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            samples.push_back({0, 64, 0});
+            samples.push_back({64, 64, 1});
+            break;
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+            samples.push_back({0, 128, KHR_DF_SAMPLE_DATATYPE_FLOAT});
+            break;
+        default:
+            samples.push_back({0, static_cast<uint32_t>(blockBytes * 8), 0});
+            break;
+    }
+
+    uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+    std::vector<uint8_t> descriptor(4 + blockSize, 0);
+    putU32(descriptor.data(), 0, static_cast<uint32_t>(descriptor.size()));
+    putU32(descriptor.data(), 4, 0);                                                    // Khronos vendor, basic descriptor type
+    putU32(descriptor.data(), 8, 2 | (blockSize << 16));                                // Version 2
+    uint32_t flags = isPremultiplied(algorithm) ? KHR_DF_FLAG_ALPHA_PREMULTIPLIED : 0;
+    putU32(descriptor.data(), 12, colorModel | (KHR_DF_PRIMARIES_BT709 << 8) | (KHR_DF_TRANSFER_LINEAR << 16) | (flags << 24));
+    putU32(descriptor.data(), 16, 3 | (3 << 8));                                        // 4x4 texel blocks
+    putU32(descriptor.data(), 20, static_cast<uint32_t>(blockBytes));                   // bytesPlane0
+    for (size_t i = 0; i < samples.size(); ++i) {
+        size_t offset = 28 + 16 * i;
+        const DescriptorSample& sample = samples[i];
+        putU32(descriptor.data(), offset, sample.bitOffset | ((sample.bitLength - 1) << 16) | (sample.channelType << 24));
+        putU32(descriptor.data(), offset + 4, 0);
+        putU32(descriptor.data(), offset + 8, 0);
+        putU32(descriptor.data(), offset + 12, sample.channelType & KHR_DF_SAMPLE_DATATYPE_FLOAT ? 0x3F800000u : 0xFFFFFFFFu);
+    }
+    return descriptor;
+}
+
+// Function to build the key/value data: the writer identification
+static std::vector<uint8_t> buildKeyValueData() {
+    std::string keyAndValue = std::string("KTXwriter") + '\0' + "TextureCompressionAlgorithmAnalytics " + TCA_ENCODER_VERSION + '\0';
+    std::vector<uint8_t> data(alignUp(4 + keyAndValue.size(), 4), 0);
+    putU32(data.data(), 0, static_cast<uint32_t>(keyAndValue.size()));
+    std::memcpy(&data[4], keyAndValue.data(), keyAndValue.size());
+    return data;
+}
+
+bool isKTX2DescriptionValid(const KTX2Description& description) {
+    if (getVkFormat(description.algorithm) == 0 || getFormatBlockBytes(description.algorithm) == 0 ||
+        description.width <= 0 || description.height <= 0 || description.layerCount < 0 || description.layerCount > MAX_TEXTURE_LAYERS ||
+        !isValidMipCount(description.width, description.height, description.mipLevels)) {
+        return false;
+    }
+    if (description.faceCount != 1 && (description.faceCount != 6 || description.width != description.height)) {
+        return false;
+    }
+    return description.supercompressionScheme == KTX2_SUPERCOMPRESSION_NONE ||
+           description.supercompressionScheme == KTX2_SUPERCOMPRESSION_LZ_BLOCK;
+}
+
+size_t getKTX2LevelBytes(const KTX2Description& description, int mipLevel) {
+    return multiplySizes(getMipSurfaceBytes(description.algorithm, description.width, description.height, mipLevel),
+                         static_cast<size_t>(description.imageCount()));
+}
+
+bool writeKTX2(const std::string& filePath, const KTX2Description& description, const uint8_t* payload, size_t payloadBytes,
+               int threadCount) {
+    TRACE_SCOPE("writeKTX2");
+    if (!isKTX2DescriptionValid(description)) {
+        LOG_ERROR("Cannot describe " << getAlgorithmName(description.algorithm) << " " << description.width << "x" << description.height
+                  << " with " << description.mipLevels << " mips in a KTX2 file: " << filePath);
+        return false;
+    }
+
+    // Level data in payload order (largest first)
+    std::vector<size_t> payloadOffsets(description.mipLevels);
+    size_t expectedBytes = 0;
+    for (int level = 0; level < description.mipLevels; ++level) {
+        payloadOffsets[level] = expectedBytes;
+        expectedBytes += getKTX2LevelBytes(description, level);
+    }
+    if (payloadBytes != expectedBytes) {
+        LOG_ERROR("KTX2 payload is " << payloadBytes << " bytes, expected " << expectedBytes << ": " << filePath);
+        return false;
+    }
+
+    bool supercompressed = description.supercompressionScheme == KTX2_SUPERCOMPRESSION_LZ_BLOCK;
+    std::vector<std::vector<uint8_t>> compressedLevels(supercompressed ? description.mipLevels : 0);
+    if (supercompressed) {
+        parallelFor(description.mipLevels, resolveThreadCount(threadCount), [&](int level) {
+            lzCompress(payload + payloadOffsets[level], getKTX2LevelBytes(description, level), compressedLevels[level]);
+        });
+    }
+
+    std::vector<uint8_t> descriptor = buildDataFormatDescriptor(description.algorithm);
+    std::vector<uint8_t> keyValueData = buildKeyValueData();
+    size_t descriptorOffset = HEADER_BYTES + LEVEL_ENTRY_BYTES * description.mipLevels;
+    size_t keyValueOffset = descriptorOffset + descriptor.size();
+    size_t dataStart = keyValueOffset + keyValueData.size();
+
+    // Levels are stored smallest first; uncompressed levels are aligned to the block size
+    size_t alignment = supercompressed ? 1 : static_cast<size_t>(getFormatBlockBytes(description.algorithm));
+    std::vector<uint8_t> header(dataStart, 0);
+    std::memcpy(header.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    putU32(header.data(), OFFSET_VK_FORMAT, getVkFormat(description.algorithm));
+    putU32(header.data(), OFFSET_TYPE_SIZE, 1);
+    putU32(header.data(), OFFSET_PIXEL_WIDTH, static_cast<uint32_t>(description.width));
+    putU32(header.data(), OFFSET_PIXEL_HEIGHT, static_cast<uint32_t>(description.height));
+    putU32(header.data(), OFFSET_PIXEL_DEPTH, 0);
+    putU32(header.data(), OFFSET_LAYER_COUNT, static_cast<uint32_t>(description.layerCount));
+    putU32(header.data(), OFFSET_FACE_COUNT, static_cast<uint32_t>(description.faceCount));
+    putU32(header.data(), OFFSET_LEVEL_COUNT, static_cast<uint32_t>(description.mipLevels));
+    putU32(header.data(), OFFSET_SUPERCOMPRESSION, description.supercompressionScheme);
+    putU32(header.data(), OFFSET_DFD_OFFSET, static_cast<uint32_t>(descriptorOffset));
+    putU32(header.data(), OFFSET_DFD_LENGTH, static_cast<uint32_t>(descriptor.size()));
+    putU32(header.data(), OFFSET_KVD_OFFSET, static_cast<uint32_t>(keyValueOffset));
+    putU32(header.data(), OFFSET_KVD_LENGTH, static_cast<uint32_t>(keyValueData.size()));
+    std::copy(descriptor.begin(), descriptor.end(), header.begin() + descriptorOffset);
+    std::copy(keyValueData.begin(), keyValueData.end(), header.begin() + keyValueOffset);
+
+    std::vector<size_t> fileOffsets(description.mipLevels);
+    size_t end = dataStart;
+    for (int level = description.mipLevels - 1; level >= 0; --level) {
+        size_t levelBytes = supercompressed ? compressedLevels[level].size() : getKTX2LevelBytes(description, level);
+        fileOffsets[level] = alignUp(end, alignment);
+        end = fileOffsets[level] + levelBytes;
+        size_t entry = HEADER_BYTES + LEVEL_ENTRY_BYTES * level;
+        putU64(header.data(), entry, fileOffsets[level]);
+        putU64(header.data(), entry + 8, levelBytes);
+        putU64(header.data(), entry + 16, getKTX2LevelBytes(description, level));
+    }
+
+    std::ofstream outFile(filePath, std::ios::binary);
+    if (!outFile) {
+        LOG_ERROR("Failed to open file for writing: " << filePath);
+        return false;
+    }
+    outFile.write(reinterpret_cast<const char*>(header.data()), header.size());
+    size_t written = header.size();
+    static const char padding[16] = {};
+    for (int level = description.mipLevels - 1; level >= 0; --level) {
+        outFile.write(padding, fileOffsets[level] - written);
+        const uint8_t* levelData = supercompressed ? compressedLevels[level].data() : payload + payloadOffsets[level];
+        size_t levelBytes = supercompressed ? compressedLevels[level].size() : getKTX2LevelBytes(description, level);
+        outFile.write(reinterpret_cast<const char*>(levelData), levelBytes);
+        written = fileOffsets[level] + levelBytes;
+    }
+    if (!outFile) {
+        LOG_ERROR("Failed to write KTX2 file: " << filePath);
+        return false;
+    }
+    return true;
+}
+
+bool KTX2File::open(const std::string& filePath) {
+    TRACE_SCOPE("KTX2File::open");
+    description_ = KTX2Description();
+    levels_.clear();
+    if (!file_.open(filePath)) {
+        return false;
+    }
+
+    const uint8_t* bytes = file_.data();
+    size_t size = file_.size();
+    if (size < HEADER_BYTES || std::memcmp(bytes, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        LOG_ERROR("Not a KTX2 file: " << filePath);
+        file_.close();
+        return false;
+    }
+
+    // The premultiplied flag lives in the data format descriptor
+    bool premultiplied = false;
+    size_t descriptorOffset = getU32(bytes, OFFSET_DFD_OFFSET);
+    if (getU32(bytes, OFFSET_DFD_LENGTH) >= 16 && descriptorOffset <= size - 16) {
+        premultiplied = (bytes[descriptorOffset + 15] & KHR_DF_FLAG_ALPHA_PREMULTIPLIED) != 0;
+    }
+
+    // Dimensions and layers beyond the limits are rejected before they reach an int or a size product
+    uint32_t width = getU32(bytes, OFFSET_PIXEL_WIDTH);
+    uint32_t height = getU32(bytes, OFFSET_PIXEL_HEIGHT);
+    uint32_t layerCount = getU32(bytes, OFFSET_LAYER_COUNT);
+    uint32_t faceCount = getU32(bytes, OFFSET_FACE_COUNT);
+    uint32_t levelCount = getU32(bytes, OFFSET_LEVEL_COUNT);
+    if (width > MAX_TEXTURE_DIMENSION || height > MAX_TEXTURE_DIMENSION || layerCount > MAX_TEXTURE_LAYERS) {
+        LOG_ERROR("KTX2 dimensions " << width << "x" << height << " or layer count " << layerCount << " exceed the supported limits: " << filePath);
+        file_.close();
+        return false;
+    }
+
+    KTX2Description description;
+    description.width = static_cast<int>(width);
+    description.height = static_cast<int>(height);
+    description.layerCount = static_cast<int>(layerCount);
+    description.faceCount = static_cast<int>(faceCount);
+    description.mipLevels = levelCount > 0 ? static_cast<int>(levelCount) : 1; // 0 asks the loader to generate mips
+    description.supercompressionScheme = getU32(bytes, OFFSET_SUPERCOMPRESSION);
+    if (!parseVkFormat(getU32(bytes, OFFSET_VK_FORMAT), premultiplied, description.algorithm) ||
+        getU32(bytes, OFFSET_TYPE_SIZE) != 1 || getU32(bytes, OFFSET_PIXEL_DEPTH) != 0 || !isKTX2DescriptionValid(description) ||
+        size < HEADER_BYTES + LEVEL_ENTRY_BYTES * static_cast<size_t>(description.mipLevels)) {
+        LOG_ERROR("Unsupported KTX2 format or layout: " << filePath);
+        file_.close();
+        return false;
+    }
+
+    // Check every level against the file and the size its dimensions imply
+    bool supercompressed = description.supercompressionScheme != KTX2_SUPERCOMPRESSION_NONE;
+    for (int level = 0; level < description.mipLevels; ++level) {
+        size_t entry = HEADER_BYTES + LEVEL_ENTRY_BYTES * level;
+        LevelEntry levelEntry = {getU64(bytes, entry), getU64(bytes, entry + 8), getU64(bytes, entry + 16)};
+        uint64_t expectedBytes = getKTX2LevelBytes(description, level);
+        if (expectedBytes == SIZE_MAX || levelEntry.byteOffset > size || levelEntry.byteLength > size - levelEntry.byteOffset ||
+            levelEntry.uncompressedByteLength != expectedBytes || (!supercompressed && levelEntry.byteLength != expectedBytes)) {
+            LOG_ERROR("KTX2 level " << level << " is truncated or has the wrong size: " << filePath);
+            file_.close();
+            levels_.clear();
+            return false;
+        }
+        levels_.push_back(levelEntry);
+    }
+    description_ = description;
+    return true;
+}
+
+const uint8_t* KTX2File::levelData(int mipLevel, std::vector<uint8_t>& scratch) const {
+    if (!file_.isOpen() || mipLevel < 0 || mipLevel >= static_cast<int>(levels_.size())) {
+        return nullptr;
+    }
+    const LevelEntry& level = levels_[mipLevel];
+    const uint8_t* stored = file_.data() + level.byteOffset;
+    if (description_.supercompressionScheme == KTX2_SUPERCOMPRESSION_NONE) {
+        return stored;
+    }
+    scratch.resize(static_cast<size_t>(level.uncompressedByteLength));
+    if (!lzDecompress(stored, static_cast<size_t>(level.byteLength), scratch.data(), scratch.size())) {
+        LOG_ERROR_RATE_LIMITED("KTX2 level " << mipLevel << " is corrupt");
+        return nullptr;
+    }
+    return scratch.data();
+}
+
+bool KTX2File::readAllLevels(std::vector<std::vector<uint8_t>>& levels, int threadCount) const {
+    TRACE_SCOPE("KTX2File::readAllLevels");
+    int levelCount = static_cast<int>(levels_.size());
+    levels.assign(levelCount, std::vector<uint8_t>());
+    std::atomic<bool> ok(levelCount > 0);
+    parallelFor(levelCount, resolveThreadCount(threadCount), [&](int level) {
+        std::vector<uint8_t>& output = levels[level];
+        const uint8_t* data = levelData(level, output);
+        if (!data) {
+            ok = false;
+        } else if (data != output.data()) {
+            output.assign(data, data + levels_[level].uncompressedByteLength); // Uncompressed: copy out of the mapping
+        }
+    });
+    return ok;
+}
+
+size_t KTX2File::imageOffset(int mipLevel, int imageIndex) const {
+    return getMipSurfaceBytes(description_.algorithm, description_.width, description_.height, mipLevel) * imageIndex;
+}
@@ -0,0 +1,145 @@
+#include <cstring>
+#include "../include/container/lz_block.h"
+
+// Format limits of LZ4 blocks
+static const size_t MIN_MATCH = 4;
+static const size_t LAST_LITERALS = 5;    // The last five bytes are always literals
+static const size_t MATCH_SAFE_END = 12;  // No match may start within the last twelve bytes
+static const size_t MAX_OFFSET = 65535;
+
+// Match finder: the last position of each hashed four-byte sequence
+static const int HASH_BITS = 14;
+
+static inline uint32_t read32(const uint8_t* bytes) {
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static inline uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Helper function to append a length in the 255-continuation encoding
+static void writeLength(std::vector<uint8_t>& output, size_t length) {
+    while (length >= 255) {
+        output.push_back(255);
+        length -= 255;
+    }
+    output.push_back(static_cast<uint8_t>(length));
+}
+
+// Helper function to append one sequence: literals, then a match unless matchLength is 0
+static void writeSequence(std::vector<uint8_t>& output, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength ? matchLength - MIN_MATCH : 0;
+    uint8_t token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4 | (matchCode >= 15 ? 15 : matchCode));
+    output.push_back(token);
+    if (literalLength >= 15) {
+        writeLength(output, literalLength - 15);
+    }
+    output.insert(output.end(), literals, literals + literalLength);
+    if (matchLength) {
+        output.push_back(static_cast<uint8_t>(offset));
+        output.push_back(static_cast<uint8_t>(offset >> 8));
+        if (matchCode >= 15) {
+            writeLength(output, matchCode - 15);
+        }
+    }
+}
+
+void lzCompress(const uint8_t* input, size_t inputBytes, std::vector<uint8_t>& output) {
+    output.clear();
+    output.reserve(inputBytes + inputBytes / 255 + 16);
+
+    size_t anchor = 0;
+    if (inputBytes > MATCH_SAFE_END) {
+        std::vector<uint32_t> table(static_cast<size_t>(1) << HASH_BITS, 0);
+        size_t matchLimit = inputBytes - LAST_LITERALS;
+        size_t position = 1; // Position 0 doubles as "empty" in the table
+        while (position + MATCH_SAFE_END <= inputBytes) {
+            uint32_t sequence = read32(input + position);
+            uint32_t& slot = table[hashSequence(sequence)];
+            size_t candidate = slot;
+            slot = static_cast<uint32_t>(position);
+            if (candidate == 0 || position - candidate > MAX_OFFSET || read32(input + candidate) != sequence) {
+                ++position;
+                continue;
+            }
+
+            // Extend backwards over pending literals, then forwards up to the literal tail
+            while (position > anchor && candidate > 0 && input[position - 1] == input[candidate - 1]) {
+                --position;
+                --candidate;
+            }
+            size_t length = MIN_MATCH;
+            while (position + length < matchLimit && input[position + length] == input[candidate + length]) {
+                ++length;
+            }
+
+            writeSequence(output, input + anchor, position - anchor, position - candidate, length);
+            position += length;
+            anchor = position;
+            if (position + MATCH_SAFE_END <= inputBytes && position >= 2) {
+                table[hashSequence(read32(input + position - 2))] = static_cast<uint32_t>(position - 2);
+            }
+        }
+    }
+    writeSequence(output, input + anchor, inputBytes - anchor, 0, 0);
+}
+
+bool lzDecompress(const uint8_t* input, size_t inputBytes, uint8_t* output, size_t outputBytes) {
+    size_t in = 0;
+    size_t out = 0;
+    while (in < inputBytes) {
+        uint8_t token = input[in++];
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15) {
+            uint8_t extra;
+            do {
+                if (in >= inputBytes) return false;
+                extra = input[in++];
+                literalLength += extra;
+            } while (extra == 255);
+        }
+        if (literalLength > inputBytes - in || literalLength > outputBytes - out) {
+            return false;
+        }
+        std::memcpy(output + out, input + in, literalLength);
+        in += literalLength;
+        out += literalLength;
+        if (in == inputBytes) {
+            break; // The last sequence has no match
+        }
+
+        if (inputBytes - in < 2) return false;
+        size_t offset = input[in] | (static_cast<size_t>(input[in + 1]) << 8);
+        in += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15) {
+            uint8_t extra;
+            do {
+                if (in >= inputBytes) return false;
+                extra = input[in++];
+                matchLength += extra;
+            } while (extra == 255);
+        }
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > out || matchLength > outputBytes - out) {
+            return false;
+        }
+
+        // Byte by byte: the source may overlap the bytes being written (run-length matches)
+        const uint8_t* match = output + out - offset;
+        uint8_t* destination = output + out;
+        if (offset >= matchLength) {
+            std::memcpy(destination, match, matchLength);
+        } else {
+            for (size_t i = 0; i < matchLength; ++i) {
+                destination[i] = match[i];
+            }
+        }
+        out += matchLength;
+    }
+    return out == outputBytes;
+}
@@ -0,0 +1,73 @@
+#include <fstream>
+#include "../include/container/mapped_file.h"
+#include "../include/analytics/trace.h"
+#include "../include/logging/logger.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filePath) {
+    TRACE_SCOPE("MappedFile::open");
+    close();
+
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open file for reading: " << filePath);
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+        ::close(fd);
+        LOG_ERROR("Failed to read file or file is empty: " << filePath);
+        return false;
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("Failed to map file: " << filePath);
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(mapping);
+    size_ = static_cast<size_t>(status.st_size);
+    mapped_ = true;
+    return true;
+#else
+    std::ifstream inFile(filePath, std::ios::binary | std::ios::ate);
+    if (!inFile) {
+        LOG_ERROR("Failed to open file for reading: " << filePath);
+        return false;
+    }
+    std::streamsize size = inFile.tellg();
+    inFile.seekg(0, std::ios::beg);
+    buffer_.resize(static_cast<size_t>(size));
+    if (size <= 0 || !inFile.read(reinterpret_cast<char*>(buffer_.data()), size)) {
+        buffer_.clear();
+        LOG_ERROR("Failed to read file or file is empty: " << filePath);
+        return false;
+    }
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (mapped_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+}
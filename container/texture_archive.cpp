@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include "../include/container/byte_order.h"
+#include "../include/container/texture_archive.h"
+#include "../include/cache/xxhash64.h"
+#include "../include/analytics/trace.h"
+#include "../include/logging/logger.h"
+
+namespace fs = std::filesystem;
+
+// Header layout: magic, version, entry count, then the offsets of the index and name table
+static const char ARCHIVE_MAGIC[8] = {'T', 'C', 'A', 'R', 'C', 'H', 'V', '\0'};
+static const uint32_t ARCHIVE_VERSION = 1;
+static const size_t HEADER_BYTES = 64;
+static const size_t OFFSET_VERSION = 8;
+static const size_t OFFSET_ENTRY_COUNT = 12;
+static const size_t OFFSET_INDEX = 16;
+static const size_t OFFSET_NAMES = 24;
+static const size_t OFFSET_NAMES_BYTES = 32;
+
+// Index entry layout; one cache line per entry
+static const size_t INDEX_ENTRY_BYTES = 64;
+static const size_t ENTRY_NAME_HASH = 0;
+static const size_t ENTRY_DATA_OFFSET = 8;
+static const size_t ENTRY_DATA_BYTES = 16;
+static const size_t ENTRY_NAME_OFFSET = 24;
+static const size_t ENTRY_NAME_LENGTH = 28;
+static const size_t ENTRY_KIND = 32;
+static const size_t ENTRY_ALGORITHM = 36;
+static const size_t ENTRY_WIDTH = 40;
+static const size_t ENTRY_HEIGHT = 44;
+static const size_t ENTRY_MIP_LEVELS = 48;
+
+static uint64_t hashName(std::string_view name) {
+    return xxHash64(name.data(), name.size());
+}
+
+TextureArchiveWriter::~TextureArchiveWriter() {
+    abandon();
+}
+
+bool TextureArchiveWriter::open(const std::string& filePath, size_t bufferBytes) {
+    abandon();
+    filePath_ = filePath;
+    temporaryPath_ = filePath + ".tmp";
+    file_.open(temporaryPath_, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        LOG_ERROR("Failed to open file for writing: " << temporaryPath_);
+        return false;
+    }
+    buffer_.resize(std::max(bufferBytes, HEADER_BYTES));
+    bufferUsed_ = 0;
+    position_ = 0;
+    failed_ = false;
+    entries_.clear();
+    names_.clear();
+
+    // The header is rewritten with the final offsets once the index is in place
+    std::vector<uint8_t> header(HEADER_BYTES, 0);
+    return append(header.data(), header.size());
+}
+
+bool TextureArchiveWriter::add(const std::string& name, const ArchiveEntryInfo& info, const uint8_t* data, size_t size) {
+    TRACE_SCOPE("TextureArchiveWriter::add");
+    if (!file_.is_open() || failed_) {
+        return false;
+    }
+    if (!names_.insert(name).second) {
+        LOG_ERROR("Duplicate archive entry: " << name);
+        return false;
+    }
+    if (!pad(ARCHIVE_DATA_ALIGNMENT)) {
+        return false;
+    }
+    entries_.push_back({name, info, position_, size});
+    return append(data, size);
+}
+
+bool TextureArchiveWriter::finish() {
+    TRACE_SCOPE("TextureArchiveWriter::finish");
+    if (!file_.is_open() || failed_ || !pad(ARCHIVE_DATA_ALIGNMENT)) {
+        abandon();
+        return false;
+    }
+
+    // Lookups binary search on the name hash, so the index is stored in hash order
+    std::vector<std::pair<uint64_t, const PendingEntry*>> order;
+    order.reserve(entries_.size());
+    for (const PendingEntry& entry : entries_) {
+        order.push_back({hashName(entry.name), &entry});
+    }
+    std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first < b.first : a.second->name < b.second->name;
+    });
+
+    uint64_t indexOffset = position_;
+    uint64_t namesOffset = indexOffset + order.size() * INDEX_ENTRY_BYTES;
+    std::string names;
+    std::vector<uint8_t> record(INDEX_ENTRY_BYTES);
+    for (const auto& item : order) {
+        const PendingEntry& entry = *item.second;
+        std::fill(record.begin(), record.end(), 0);
+        putU64(record.data(), ENTRY_NAME_HASH, item.first);
+        putU64(record.data(), ENTRY_DATA_OFFSET, entry.offset);
+        putU64(record.data(), ENTRY_DATA_BYTES, entry.size);
+        putU32(record.data(), ENTRY_NAME_OFFSET, static_cast<uint32_t>(names.size()));
+        putU32(record.data(), ENTRY_NAME_LENGTH, static_cast<uint32_t>(entry.name.size()));
+        putU32(record.data(), ENTRY_KIND, static_cast<uint32_t>(entry.info.kind));
+        putU32(record.data(), ENTRY_ALGORITHM, static_cast<uint32_t>(entry.info.algorithm));
+        putU32(record.data(), ENTRY_WIDTH, static_cast<uint32_t>(entry.info.width));
+        putU32(record.data(), ENTRY_HEIGHT, static_cast<uint32_t>(entry.info.height));
+        putU32(record.data(), ENTRY_MIP_LEVELS, static_cast<uint32_t>(entry.info.mipLevels));
+        names += entry.name;
+        if (!append(record.data(), record.size())) {
+            abandon();
+            return false;
+        }
+    }
+    if (!append(reinterpret_cast<const uint8_t*>(names.data()), names.size()) || !flush()) {
+        abandon();
+        return false;
+    }
+
+    uint8_t header[HEADER_BYTES] = {};
+    std::memcpy(header, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    putU32(header, OFFSET_VERSION, ARCHIVE_VERSION);
+    putU32(header, OFFSET_ENTRY_COUNT, static_cast<uint32_t>(order.size()));
+    putU64(header, OFFSET_INDEX, indexOffset);
+    putU64(header, OFFSET_NAMES, namesOffset);
+    putU64(header, OFFSET_NAMES_BYTES, names.size());
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(header), HEADER_BYTES);
+    file_.close();
+    if (!file_) {
+        LOG_ERROR("Failed to write archive: " << temporaryPath_);
+        abandon();
+        return false;
+    }
+
+    std::error_code error;
+    fs::rename(temporaryPath_, filePath_, error);
+    if (error) {
+        LOG_ERROR("Failed to replace archive " << filePath_ << ": " << error.message());
+        abandon();
+        return false;
+    }
+    temporaryPath_.clear();
+    return true;
+}
+
+// Helper function to copy data into the buffer, writing it out whenever the buffer fills. Payloads
+// at least as large as the buffer skip the copy and go straight to the file.
+bool TextureArchiveWriter::append(const uint8_t* data, size_t size) {
+    if (size >= buffer_.size()) {
+        if (!flush()) {
+            return false;
+        }
+        file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    } else {
+        if (bufferUsed_ + size > buffer_.size() && !flush()) {
+            return false;
+        }
+        std::memcpy(buffer_.data() + bufferUsed_, data, size);
+        bufferUsed_ += size;
+    }
+    position_ += size;
+    if (!file_) {
+        LOG_ERROR("Failed to write archive: " << temporaryPath_);
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+// Helper function to append zero bytes up to the next multiple of alignment
+bool TextureArchiveWriter::pad(size_t alignment) {
+    static const uint8_t zeros[ARCHIVE_DATA_ALIGNMENT] = {};
+    size_t padding = static_cast<size_t>((alignment - position_ % alignment) % alignment);
+    return padding == 0 || append(zeros, padding);
+}
+
+bool TextureArchiveWriter::flush() {
+    if (bufferUsed_ > 0) {
+        file_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(bufferUsed_));
+        bufferUsed_ = 0;
+    }
+    if (!file_) {
+        LOG_ERROR("Failed to write archive: " << temporaryPath_);
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+// Helper function to drop an unfinished archive, removing its temporary file
+void TextureArchiveWriter::abandon() {
+    if (file_.is_open()) {
+        file_.close();
+    }
+    if (!temporaryPath_.empty()) {
+        std::error_code error;
+        fs::remove(temporaryPath_, error);
+        temporaryPath_.clear();
+    }
+    bufferUsed_ = 0;
+}
+
+bool TextureArchive::open(const std::string& filePath) {
+    TRACE_SCOPE("TextureArchive::open");
+    entryCount_ = 0;
+    index_ = nullptr;
+    names_ = nullptr;
+    if (!file_.open(filePath)) {
+        return false;
+    }
+
+    const uint8_t* bytes = file_.data();
+    uint64_t size = file_.size();
+    if (size < HEADER_BYTES || std::memcmp(bytes, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 ||
+        getU32(bytes, OFFSET_VERSION) != ARCHIVE_VERSION) {
+        LOG_ERROR("Not a texture archive: " << filePath);
+        file_.close();
+        return false;
+    }
+
+    // Check every range once here so lookups can trust the index
+    uint64_t entryCount = getU32(bytes, OFFSET_ENTRY_COUNT);
+    uint64_t indexOffset = getU64(bytes, OFFSET_INDEX);
+    uint64_t namesOffset = getU64(bytes, OFFSET_NAMES);
+    uint64_t namesBytes = getU64(bytes, OFFSET_NAMES_BYTES);
+    bool valid = indexOffset >= HEADER_BYTES && indexOffset <= size && entryCount <= (size - indexOffset) / INDEX_ENTRY_BYTES &&
+                 namesOffset == indexOffset + entryCount * INDEX_ENTRY_BYTES && namesBytes <= size - namesOffset;
+    for (uint64_t i = 0; valid && i < entryCount; ++i) {
+        const uint8_t* record = bytes + indexOffset + i * INDEX_ENTRY_BYTES;
+        uint64_t dataOffset = getU64(record, ENTRY_DATA_OFFSET);
+        uint64_t dataBytes = getU64(record, ENTRY_DATA_BYTES);
+        uint64_t nameOffset = getU32(record, ENTRY_NAME_OFFSET);
+        uint64_t nameLength = getU32(record, ENTRY_NAME_LENGTH);
+        valid = dataOffset >= HEADER_BYTES && dataOffset <= indexOffset && dataBytes <= indexOffset - dataOffset &&
+                nameOffset <= namesBytes && nameLength <= namesBytes - nameOffset &&
+                (i == 0 || getU64(record - INDEX_ENTRY_BYTES, ENTRY_NAME_HASH) <= getU64(record, ENTRY_NAME_HASH));
+    }
+    if (!valid) {
+        LOG_ERROR("Texture archive index is truncated or corrupt: " << filePath);
+        file_.close();
+        return false;
+    }
+
+    entryCount_ = static_cast<size_t>(entryCount);
+    index_ = bytes + indexOffset;
+    names_ = bytes + namesOffset;
+    return true;
+}
+
+ArchiveEntry TextureArchive::entry(size_t index) const {
+    const uint8_t* record = index_ + index * INDEX_ENTRY_BYTES;
+    ArchiveEntry entry;
+    entry.name = std::string_view(reinterpret_cast<const char*>(names_) + getU32(record, ENTRY_NAME_OFFSET), getU32(record, ENTRY_NAME_LENGTH));
+    entry.info.kind = static_cast<ArchiveEntryKind>(getU32(record, ENTRY_KIND));
+    entry.info.algorithm = static_cast<CompressionAlgorithm>(getU32(record, ENTRY_ALGORITHM));
+    entry.info.width = static_cast<int>(getU32(record, ENTRY_WIDTH));
+    entry.info.height = static_cast<int>(getU32(record, ENTRY_HEIGHT));
+    entry.info.mipLevels = static_cast<int>(getU32(record, ENTRY_MIP_LEVELS));
+    entry.data = file_.data() + getU64(record, ENTRY_DATA_OFFSET);
+    entry.size = static_cast<size_t>(getU64(record, ENTRY_DATA_BYTES));
+    return entry;
+}
+
+bool TextureArchive::find(std::string_view name, ArchiveEntry& entry) const {
+    uint64_t hash = hashName(name);
+
+    // First index position whose hash is not below the one searched for
+    size_t low = 0;
+    size_t high = entryCount_;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (getU64(index_ + middle * INDEX_ENTRY_BYTES, ENTRY_NAME_HASH) < hash) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    for (size_t i = low; i < entryCount_ && getU64(index_ + i * INDEX_ENTRY_BYTES, ENTRY_NAME_HASH) == hash; ++i) {
+        ArchiveEntry candidate = this->entry(i);
+        if (candidate.name == name) {
+            entry = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "../include/corpus/synthetic_texture.h"
+#include "../include/thread_ranges.h"
+#include "../include/analytics/trace.h"
+#include "../include/logging/logger.h"
+
+// Helper function mixing a 64-bit value (SplitMix64 finaliser)
+static inline uint64_t mix64(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// Helper function hashing a lattice coordinate into [0, 1)
+static inline float latticeValue(uint64_t seed, int x, int y) {
+    uint64_t h = mix64(seed ^ mix64((static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y)));
+    return static_cast<float>(h >> 40) / static_cast<float>(1ull << 24);
+}
+
+// Helper function returning a random 8-bit channel value for a seed and a salt
+static inline uint8_t randomChannel(uint64_t seed, uint64_t salt) {
+    return static_cast<uint8_t>(mix64(seed * 31 + salt) >> 56);
+}
+
+// Function to sample smoothly interpolated value noise with the given lattice period in pixels
+static float valueNoise(uint64_t seed, float x, float y, float period) {
+    float fx = x / period;
+    float fy = y / period;
+    int x0 = static_cast<int>(std::floor(fx));
+    int y0 = static_cast<int>(std::floor(fy));
+    float tx = fx - x0;
+    float ty = fy - y0;
+    tx = tx * tx * (3.0f - 2.0f * tx);
+    ty = ty * ty * (3.0f - 2.0f * ty);
+
+    float v00 = latticeValue(seed, x0, y0);
+    float v10 = latticeValue(seed, x0 + 1, y0);
+    float v01 = latticeValue(seed, x0, y0 + 1);
+    float v11 = latticeValue(seed, x0 + 1, y0 + 1);
+
+    float top = v00 + (v10 - v00) * tx;
+    float bottom = v01 + (v11 - v01) * tx;
+    return top + (bottom - top) * ty;
+}
+
+// Function to sum four octaves of value noise, normalised to [0, 1)
+static float fractalNoise(uint64_t seed, float x, float y, float basePeriod) {
+    float sum = 0.0f;
+    float amplitude = 0.5f;
+    float period = basePeriod;
+    for (int octave = 0; octave < 4; ++octave) {
+        sum += amplitude * valueNoise(mix64(seed + octave), x, y, std::max(period, 1.0f));
+        amplitude *= 0.5f;
+        period *= 0.5f;
+    }
+    return sum / 0.9375f;
+}
+
+static inline uint8_t toByte(float value) {
+    return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, value * 255.0f + 0.5f)));
+}
+
+// Function to generate one texel of a pattern; every pattern is a pure function of (x, y, seed)
+static void generateTexel(SyntheticPattern pattern, int x, int y, int width, int height, uint64_t seed, uint8_t* texel) {
+    // Feature scale grows with the image so large textures are not pure noise
+    float period = std::max(4.0f, std::min(width, height) / 8.0f);
+
+    switch (pattern) {
+        case SyntheticPattern::Gradient: {
+            float t = (static_cast<float>(x) + y) / std::max(1, width + height - 2);
+            for (int c = 0; c < 3; ++c) {
+                float from = randomChannel(seed, c);
+                float to = randomChannel(seed, c + 3);
+                texel[c] = toByte((from + (to - from) * t) / 255.0f);
+            }
+            texel[3] = 255;
+            break;
+        }
+        case SyntheticPattern::Checkerboard: {
+            int cell = 4 << (mix64(seed) % 4); // 4, 8, 16 or 32 pixels
+            bool odd = ((x / cell) + (y / cell)) & 1;
+            for (int c = 0; c < 3; ++c) {
+                texel[c] = randomChannel(seed, c + (odd ? 3 : 0));
+            }
+            texel[3] = 255;
+            break;
+        }
+        case SyntheticPattern::ValueNoise: {
+            for (int c = 0; c < 3; ++c) {
+                texel[c] = toByte(fractalNoise(seed + c * 0x1000, static_cast<float>(x), static_cast<float>(y), period));
+            }
+            texel[3] = 255;
+            break;
+        }
+        case SyntheticPattern::FlatAtlas: {
+            int cellWidth = 16 << (mix64(seed) % 3);  // 16, 32 or 64 pixels
+            int cellHeight = 16 << (mix64(seed + 1) % 3);
+            int cellX = x / cellWidth;
+            int cellY = y / cellHeight;
+            uint64_t cellSeed = mix64(seed ^ (static_cast<uint64_t>(cellX) << 32 | static_cast<uint32_t>(cellY)));
+            bool border = (x % cellWidth) == 0 || (y % cellHeight) == 0;
+            for (int c = 0; c < 3; ++c) {
+                texel[c] = border ? 0 : randomChannel(cellSeed, c);
+            }
+            texel[3] = 255;
+            break;
+        }
+        case SyntheticPattern::NormalMap: {
+            const float strength = 4.0f;
+            float fx = static_cast<float>(x);
+            float fy = static_cast<float>(y);
+            float dx = fractalNoise(seed, fx + 1.0f, fy, period) - fractalNoise(seed, fx - 1.0f, fy, period);
+            float dy = fractalNoise(seed, fx, fy + 1.0f, period) - fractalNoise(seed, fx, fy - 1.0f, period);
+            float nx = -dx * strength;
+            float ny = -dy * strength;
+            float nz = 1.0f;
+            float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+            texel[0] = toByte(nx / length * 0.5f + 0.5f);
+            texel[1] = toByte(ny / length * 0.5f + 0.5f);
+            texel[2] = toByte(nz / length * 0.5f + 0.5f);
+            texel[3] = 255;
+            break;
+        }
+        case SyntheticPattern::SharpAlpha: {
+            for (int c = 0; c < 3; ++c) {
+                texel[c] = toByte(fractalNoise(seed + c * 0x1000, static_cast<float>(x), static_cast<float>(y), period));
+            }
+            texel[3] = fractalNoise(seed + 0x5000, static_cast<float>(x), static_cast<float>(y), period) > 0.5f ? 255 : 0;
+            break;
+        }
+        case SyntheticPattern::SmoothAlpha: {
+            float t = (static_cast<float>(x) + y) / std::max(1, width + height - 2);
+            for (int c = 0; c < 3; ++c) {
+                float from = randomChannel(seed, c);
+                float to = randomChannel(seed, c + 3);
+                texel[c] = toByte((from + (to - from) * t) / 255.0f);
+            }
+            texel[3] = toByte(fractalNoise(seed + 0x5000, static_cast<float>(x), static_cast<float>(y), period));
+            break;
+        }
+    }
+}
+
+const std::vector<SyntheticPattern>& getSyntheticPatterns() {
+    static const std::vector<SyntheticPattern> patterns = {
+        SyntheticPattern::Gradient, SyntheticPattern::Checkerboard, SyntheticPattern::ValueNoise,
+        SyntheticPattern::FlatAtlas, SyntheticPattern::NormalMap, SyntheticPattern::SharpAlpha,
+        SyntheticPattern::SmoothAlpha,
+    };
+    return patterns;
+}
+
+std::string getSyntheticPatternName(SyntheticPattern pattern) {
+    switch (pattern) {
+        case SyntheticPattern::Gradient: return "gradient";
+        case SyntheticPattern::Checkerboard: return "checkerboard";
+        case SyntheticPattern::ValueNoise: return "noise";
+        case SyntheticPattern::FlatAtlas: return "atlas";
+        case SyntheticPattern::NormalMap: return "normalmap";
+        case SyntheticPattern::SharpAlpha: return "sharpalpha";
+        case SyntheticPattern::SmoothAlpha: return "smoothalpha";
+    }
+    return "unknown";
+}
+
+bool parseSyntheticPattern(const std::string& name, SyntheticPattern& pattern) {
+    for (SyntheticPattern candidate : getSyntheticPatterns()) {
+        if (getSyntheticPatternName(candidate) == name) {
+            pattern = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<uint8_t> generateSyntheticTexture(SyntheticPattern pattern, int width, int height, uint64_t seed, int threadCount) {
+    TRACE_SCOPE("generateSyntheticTexture");
+    if (width < SYNTHETIC_MIN_SIZE || height < SYNTHETIC_MIN_SIZE || width > SYNTHETIC_MAX_SIZE || height > SYNTHETIC_MAX_SIZE) {
+        LOG_ERROR("Synthetic texture size out of range: " << width << "x" << height);
+        return {};
+    }
+
+    std::vector<uint8_t> textureData(static_cast<size_t>(width) * height * 4);
+
+    forEachRowRange(height, resolveThreadCount(threadCount), [&](int firstRow, int lastRow) {
+        for (int y = firstRow; y < lastRow; ++y) {
+            uint8_t* row = &textureData[static_cast<size_t>(y) * width * 4];
+            for (int x = 0; x < width; ++x) {
+                generateTexel(pattern, x, y, width, height, seed, row + static_cast<size_t>(x) * 4);
+            }
+        }
+    });
+
+    return textureData;
+}
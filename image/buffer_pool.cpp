@@ -0,0 +1,28 @@
+#include "../include/image/buffer_pool.h"
+
+uint8_t* BufferPool::acquire(size_t slot, size_t bytes) {
+    ++stats_.requests;
+    if (slot >= buffers_.size()) {
+        buffers_.resize(slot + 1);
+    }
+    PageBuffer& buffer = buffers_[slot];
+    if (buffer.size() < bytes) {
+        // Grow by at least half again so slowly increasing sizes do not reallocate every time.
+        // The old contents are not kept.
+        size_t capacity = bytes > buffer.size() + buffer.size() / 2 ? bytes : buffer.size() + buffer.size() / 2;
+        stats_.bytesReserved -= buffer.size();
+        stats_.hugePageBytes -= isHugePageBacked(buffer) ? buffer.size() : 0;
+        buffer.reset();
+        buffer = PageBuffer(capacity, hugePages_);
+        stats_.bytesReserved += buffer.size();
+        stats_.hugePageBytes += isHugePageBacked(buffer) ? buffer.size() : 0;
+        ++stats_.allocations;
+    }
+    return buffer.data();
+}
+
+void BufferPool::clear() {
+    buffers_.clear();
+    stats_.bytesReserved = 0;
+    stats_.hugePageBytes = 0;
+}
@@ -0,0 +1,63 @@
+#include <utility>
+#include "../include/image/image_buffer.h"
+
+ImageBuffer::~ImageBuffer() {
+    reset();
+}
+
+ImageBuffer::ImageBuffer(ImageBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+ImageBuffer& ImageBuffer::operator=(ImageBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        data_ = other.data_;
+        width_ = other.width_;
+        height_ = other.height_;
+        stride_ = other.stride_;
+        channels_ = other.channels_;
+        deleter_ = other.deleter_;
+        storage_ = std::move(other.storage_); // Moving a vector keeps its texels where they are
+        other.data_ = nullptr;
+        other.deleter_ = nullptr;
+        other.reset();
+    }
+    return *this;
+}
+
+ImageBuffer ImageBuffer::adopt(uint8_t* texels, int width, int height, size_t stride, int channels, Deleter deleter) {
+    ImageBuffer buffer;
+    buffer.data_ = texels;
+    buffer.width_ = width;
+    buffer.height_ = height;
+    buffer.stride_ = stride;
+    buffer.channels_ = channels;
+    buffer.deleter_ = deleter;
+    return buffer;
+}
+
+ImageBuffer ImageBuffer::adopt(std::vector<uint8_t>&& texels, int width, int height, int channels) {
+    ImageBuffer buffer;
+    buffer.storage_ = std::move(texels);
+    buffer.data_ = buffer.storage_.empty() ? nullptr : buffer.storage_.data();
+    buffer.width_ = width;
+    buffer.height_ = height;
+    buffer.stride_ = static_cast<size_t>(width) * channels;
+    buffer.channels_ = channels;
+    return buffer;
+}
+
+void ImageBuffer::reset() {
+    if (data_ && deleter_) {
+        deleter_(data_);
+    }
+    data_ = nullptr;
+    width_ = 0;
+    height_ = 0;
+    stride_ = 0;
+    channels_ = 4;
+    deleter_ = nullptr;
+    storage_.clear();
+    storage_.shrink_to_fit();
+}
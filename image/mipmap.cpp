@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include "../include/image/mipmap.h"
+#include "../include/thread_ranges.h"
+#include "../include/analytics/trace.h"
+
+// Lobes of the windowed-sinc filters, in destination texels
+static const float SINC_RADIUS = 3.0f;
+
+// Shape parameter of the Kaiser window
+static const float KAISER_ALPHA = 4.0f;
+
+std::string getMipFilterName(MipFilter filter) {
+    switch (filter) {
+        case MipFilter::Box: return "box";
+        case MipFilter::Kaiser: return "kaiser";
+        case MipFilter::Lanczos: return "lanczos";
+    }
+    return "unknown";
+}
+
+bool parseMipFilter(const std::string& name, MipFilter& filter) {
+    for (MipFilter candidate : {MipFilter::Box, MipFilter::Kaiser, MipFilter::Lanczos}) {
+        if (name == getMipFilterName(candidate)) {
+            filter = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+int getMipLevelCount(int width, int height) {
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        ++levels;
+    }
+    return levels;
+}
+
+// Lookup table from 8-bit sRGB to linear light
+static const float* getSRGBToLinearTable() {
+    static const std::vector<float> table = [] {
+        std::vector<float> values(256);
+        for (int i = 0; i < 256; ++i) {
+            float c = i / 255.0f;
+            values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+// Lookup table from linear light quantised to 16 bits back to 8-bit sRGB. 16 bits keep the
+// darkest steps, where the sRGB curve is steepest, within a fraction of an 8-bit code.
+static const uint8_t* getLinearToSRGBTable() {
+    static const std::vector<uint8_t> table = [] {
+        std::vector<uint8_t> values(65536);
+        for (int i = 0; i < 65536; ++i) {
+            float c = i / 65535.0f;
+            float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+            values[i] = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, s * 255.0f + 0.5f)));
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+static float sinc(float x) {
+    if (std::fabs(x) < 1e-6f) return 1.0f;
+    const float pi = 3.14159265358979f;
+    return std::sin(pi * x) / (pi * x);
+}
+
+// Zeroth-order modified Bessel function of the first kind (power series)
+static float besselI0(float x) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    float halfX = 0.5f * x;
+    for (int k = 1; k < 32; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-8f) break;
+    }
+    return sum;
+}
+
+// Function to evaluate a filter kernel at a distance in destination texels
+static float evaluateKernel(MipFilter filter, float x) {
+    x = std::fabs(x);
+    switch (filter) {
+        case MipFilter::Box:
+            return x <= 0.5f ? 1.0f : 0.0f;
+        case MipFilter::Kaiser: {
+            if (x >= SINC_RADIUS) return 0.0f;
+            float t = x / SINC_RADIUS;
+            return sinc(x) * besselI0(KAISER_ALPHA * std::sqrt(1.0f - t * t)) / besselI0(KAISER_ALPHA);
+        }
+        case MipFilter::Lanczos:
+            return x < SINC_RADIUS ? sinc(x) * sinc(x / SINC_RADIUS) : 0.0f;
+    }
+    return 0.0f;
+}
+
+// Normalised taps of a 1D resampling pass; every output has tapCount entries (zero-padded)
+struct FilterTaps {
+    int tapCount = 0;
+    std::vector<int> indices;
+    std::vector<float> weights;
+};
+
+// Function to compute the taps mapping sourceSize texels onto outputSize texels
+static FilterTaps computeFilterTaps(MipFilter filter, int sourceSize, int outputSize) {
+    float scale = static_cast<float>(sourceSize) / outputSize;
+    float support = (filter == MipFilter::Box ? 0.5f : SINC_RADIUS) * scale;
+
+    FilterTaps taps;
+    taps.tapCount = static_cast<int>(std::ceil(support * 2.0f)) + 1;
+    taps.indices.assign(static_cast<size_t>(outputSize) * taps.tapCount, 0);
+    taps.weights.assign(static_cast<size_t>(outputSize) * taps.tapCount, 0.0f);
+
+    for (int i = 0; i < outputSize; ++i) {
+        float center = (i + 0.5f) * scale;
+        int first = static_cast<int>(std::floor(center - support));
+        float total = 0.0f;
+        for (int t = 0; t < taps.tapCount; ++t) {
+            int source = first + t;
+            float weight = evaluateKernel(filter, (source + 0.5f - center) / scale);
+            size_t slot = static_cast<size_t>(i) * taps.tapCount + t;
+            taps.indices[slot] = std::min(std::max(source, 0), sourceSize - 1); // Clamp at the edges
+            taps.weights[slot] = weight;
+            total += weight;
+        }
+        for (int t = 0; t < taps.tapCount; ++t) {
+            taps.weights[static_cast<size_t>(i) * taps.tapCount + t] /= total;
+        }
+    }
+    return taps;
+}
+
+// Helper function to convert one row of a Channels-channel image to linear RGBA floats
+template <int Channels>
+static void linearizeRow(const uint8_t* source, int width, const float* toLinear, float* linearRow) {
+    for (int x = 0; x < width; ++x) {
+        uint8_t texel[4];
+        expandTexel<Channels>(source + x * Channels, texel);
+        linearRow[x * 4 + 0] = toLinear[texel[0]];
+        linearRow[x * 4 + 1] = toLinear[texel[1]];
+        linearRow[x * 4 + 2] = toLinear[texel[2]];
+        linearRow[x * 4 + 3] = texel[3] * (1.0f / 255.0f);
+    }
+}
+
+// Helper function to convert a row of linear RGBA floats in [0, 1] back to a Channels-channel row
+template <int Channels>
+static void storeRow(const float* linearRow, int width, const uint8_t* toSRGB, uint8_t* output) {
+    for (int x = 0; x < width; ++x) {
+        const float* texel = &linearRow[x * 4];
+        uint8_t* destination = output + x * Channels;
+        destination[0] = toSRGB[static_cast<int>(texel[0] * 65535.0f + 0.5f)];
+        if (Channels >= 3) {
+            destination[1] = toSRGB[static_cast<int>(texel[1] * 65535.0f + 0.5f)];
+            destination[2] = toSRGB[static_cast<int>(texel[2] * 65535.0f + 0.5f)];
+        }
+        if (Channels == 2 || Channels == 4) {
+            destination[Channels - 1] = static_cast<uint8_t>(texel[3] * 255.0f + 0.5f);
+        }
+    }
+}
+
+std::vector<uint8_t> downsampleImage(const ImageView& image, MipFilter filter, int& outputWidth, int& outputHeight, int threadCount) {
+    TRACE_SCOPE("downsampleImage");
+    int width = image.width;
+    int height = image.height;
+    outputWidth = std::max(1, width / 2);
+    outputHeight = std::max(1, height / 2);
+    threadCount = resolveThreadCount(threadCount);
+
+    const float* toLinear = getSRGBToLinearTable();
+    const uint8_t* toSRGB = getLinearToSRGBTable();
+    FilterTaps horizontal = computeFilterTaps(filter, width, outputWidth);
+    FilterTaps vertical = computeFilterTaps(filter, height, outputHeight);
+
+    // Horizontal pass: every source row, linearised, into a float buffer of outputWidth columns
+    std::vector<float> intermediate(static_cast<size_t>(outputWidth) * height * 4);
+    forEachRowRange(height, threadCount, [&](int firstRow, int lastRow) {
+        std::vector<float> linearRow(static_cast<size_t>(width) * 4);
+        for (int y = firstRow; y < lastRow; ++y) {
+            const uint8_t* source = image.row(y);
+            switch (image.channels) {
+                case 1: linearizeRow<1>(source, width, toLinear, linearRow.data()); break;
+                case 2: linearizeRow<2>(source, width, toLinear, linearRow.data()); break;
+                case 3: linearizeRow<3>(source, width, toLinear, linearRow.data()); break;
+                default: linearizeRow<4>(source, width, toLinear, linearRow.data()); break;
+            }
+            float* output = &intermediate[static_cast<size_t>(y) * outputWidth * 4];
+            for (int x = 0; x < outputWidth; ++x) {
+                float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                for (int t = 0; t < horizontal.tapCount; ++t) {
+                    size_t slot = static_cast<size_t>(x) * horizontal.tapCount + t;
+                    const float* texel = &linearRow[horizontal.indices[slot] * 4];
+                    float weight = horizontal.weights[slot];
+                    for (int c = 0; c < 4; ++c) {
+                        sum[c] += texel[c] * weight;
+                    }
+                }
+                for (int c = 0; c < 4; ++c) {
+                    output[x * 4 + c] = sum[c];
+                }
+            }
+        }
+    });
+
+    // Vertical pass: whole rows at a time so the inner loop runs over contiguous floats
+    std::vector<uint8_t> result(static_cast<size_t>(outputWidth) * outputHeight * image.channels);
+    forEachRowRange(outputHeight, threadCount, [&](int firstRow, int lastRow) {
+        size_t rowFloats = static_cast<size_t>(outputWidth) * 4;
+        std::vector<float> sum(rowFloats);
+        for (int y = firstRow; y < lastRow; ++y) {
+            std::fill(sum.begin(), sum.end(), 0.0f);
+            for (int t = 0; t < vertical.tapCount; ++t) {
+                size_t slot = static_cast<size_t>(y) * vertical.tapCount + t;
+                const float* row = &intermediate[vertical.indices[slot] * rowFloats];
+                float weight = vertical.weights[slot];
+                for (size_t i = 0; i < rowFloats; ++i) {
+                    sum[i] += row[i] * weight;
+                }
+            }
+            // Sinc lobes can over- and undershoot, so clamp before converting back
+            for (size_t i = 0; i < rowFloats; ++i) {
+                sum[i] = std::min(1.0f, std::max(0.0f, sum[i]));
+            }
+            uint8_t* output = &result[static_cast<size_t>(y) * outputWidth * image.channels];
+            switch (image.channels) {
+                case 1: storeRow<1>(sum.data(), outputWidth, toSRGB, output); break;
+                case 2: storeRow<2>(sum.data(), outputWidth, toSRGB, output); break;
+                case 3: storeRow<3>(sum.data(), outputWidth, toSRGB, output); break;
+                default: storeRow<4>(sum.data(), outputWidth, toSRGB, output); break;
+            }
+        }
+    });
+    return result;
+}
+
+std::vector<CompressedMipLevel> compressMipChain(const BlockCodec& codec, const ImageView& image, MipFilter filter, int threadCount,
+                                                 BlockDedupeCache* dedupeCache) {
+    TRACE_SCOPE("compressMipChain");
+    threadCount = resolveThreadCount(threadCount);
+
+    std::vector<CompressedMipLevel> levels(getMipLevelCount(image.width, image.height));
+    ImageView current = image;
+    std::vector<uint8_t> currentLevel;
+    for (size_t level = 0; level < levels.size(); ++level) {
+        CompressedMipLevel& output = levels[level];
+        output.width = current.width;
+        output.height = current.height;
+
+        auto encode = [&](int encodeThreads) {
+            if (dedupeCache) {
+                compressImageDeduplicated(codec, current, output.compressedData, *dedupeCache);
+            } else {
+                compressImageParallel(codec, current, output.compressedData, encodeThreads);
+            }
+        };
+
+        std::vector<uint8_t> nextLevel;
+        int nextWidth = current.width;
+        int nextHeight = current.height;
+        if (level + 1 == levels.size() || threadCount == 1) {
+            encode(threadCount);
+            if (level + 1 < levels.size()) {
+                nextLevel = downsampleImage(current, filter, nextWidth, nextHeight, threadCount);
+            }
+        } else {
+            // Encode this level in the background while the next one is filtered from it, splitting
+            // the threads between the two (the deduplicated encode runs on one)
+            int encodeThreads = dedupeCache ? 1 : threadCount / 2;
+            std::future<void> encoded = std::async(std::launch::async, encode, encodeThreads);
+            nextLevel = downsampleImage(current, filter, nextWidth, nextHeight, threadCount - encodeThreads);
+            encoded.get();
+        }
+
+        currentLevel.swap(nextLevel);
+        current = ImageView(currentLevel, nextWidth, nextHeight, image.channels);
+    }
+    return levels;
+}
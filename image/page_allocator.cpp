@@ -0,0 +1,139 @@
+#include <utility>
+#include "../include/image/page_allocator.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define TCA_HAVE_MMAP 1
+#endif
+
+std::string getHugePageModeName(HugePageMode mode) {
+    switch (mode) {
+        case HugePageMode::Off: return "off";
+        case HugePageMode::Transparent: return "transparent";
+        case HugePageMode::Explicit: return "explicit";
+    }
+    return "unknown";
+}
+
+bool parseHugePageMode(const std::string& name, HugePageMode& mode) {
+    for (HugePageMode candidate : {HugePageMode::Off, HugePageMode::Transparent, HugePageMode::Explicit}) {
+        if (name == getHugePageModeName(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string getPageBackingName(PageBacking backing) {
+    switch (backing) {
+        case PageBacking::Heap: return "heap";
+        case PageBacking::Regular: return "regular pages";
+        case PageBacking::Transparent: return "transparent huge pages";
+        case PageBacking::Explicit: return "hugetlb pages";
+    }
+    return "unknown";
+}
+
+#ifdef TCA_HAVE_MMAP
+// Helper function to round a size up to a whole number of huge pages
+static size_t roundToHugePages(size_t bytes) {
+    return (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+}
+
+// Helper function to map length bytes starting on a huge page boundary. Transparent huge pages
+// only back whole aligned 2 MiB ranges, so an extra huge page is mapped and the unaligned head
+// and tail are returned.
+static uint8_t* mapAligned(size_t length) {
+    size_t reserved = length + HUGE_PAGE_BYTES;
+    void* mapping = mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    uint8_t* start = static_cast<uint8_t*>(mapping);
+    uint8_t* aligned = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(start) + HUGE_PAGE_BYTES - 1) & ~(uintptr_t(HUGE_PAGE_BYTES) - 1));
+    if (aligned > start) {
+        munmap(start, aligned - start);
+    }
+    size_t tail = reserved - (aligned - start) - length;
+    if (tail > 0) {
+        munmap(aligned + length, tail);
+    }
+    return aligned;
+}
+#endif
+
+PageBuffer::PageBuffer(size_t bytes, HugePageMode mode) : size_(bytes) {
+    if (bytes == 0) {
+        return;
+    }
+#ifdef TCA_HAVE_MMAP
+    if (mode != HugePageMode::Off && bytes >= HUGE_PAGE_BYTES) {
+        size_t length = roundToHugePages(bytes);
+#ifdef MAP_HUGETLB
+        if (mode == HugePageMode::Explicit) {
+            // Fails unless huge pages are reserved (vm.nr_hugepages); fall through to THP then
+            void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (mapping != MAP_FAILED) {
+                data_ = static_cast<uint8_t*>(mapping);
+                mappedBytes_ = length;
+                backing_ = PageBacking::Explicit;
+                return;
+            }
+        }
+#endif
+        data_ = mapAligned(length);
+        if (data_) {
+            mappedBytes_ = length;
+            backing_ = PageBacking::Regular;
+#ifdef MADV_HUGEPAGE
+            if (madvise(data_, length, MADV_HUGEPAGE) == 0) {
+                backing_ = PageBacking::Transparent;
+            }
+#endif
+            return;
+        }
+    }
+#else
+    (void)mode;
+#endif
+    data_ = new uint8_t[bytes];
+    backing_ = PageBacking::Heap;
+}
+
+PageBuffer::~PageBuffer() {
+    reset();
+}
+
+PageBuffer::PageBuffer(PageBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+PageBuffer& PageBuffer::operator=(PageBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(mappedBytes_, other.mappedBytes_);
+        std::swap(backing_, other.backing_);
+    }
+    return *this;
+}
+
+void PageBuffer::reset() {
+    if (data_) {
+#ifdef TCA_HAVE_MMAP
+        if (backing_ != PageBacking::Heap) {
+            munmap(data_, mappedBytes_);
+        } else {
+            delete[] data_;
+        }
+#else
+        delete[] data_;
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mappedBytes_ = 0;
+    backing_ = PageBacking::Heap;
+}
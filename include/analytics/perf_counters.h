@@ -0,0 +1,51 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+// Hardware counter values for one measured region. A counter the kernel or the
+// CPU does not provide is marked missing rather than reported as zero.
+struct PerfCounterSample {
+    enum Counter { Cycles, Instructions, BranchMisses, L1DMisses, LLCMisses, CounterCount };
+
+    bool valid = false; // False when no counter could be read at all
+    uint64_t values[CounterCount] = {};
+    bool present[CounterCount] = {};
+
+    bool has(Counter counter) const { return valid && present[counter]; }
+    uint64_t get(Counter counter) const { return values[counter]; }
+
+    // Instructions per cycle, or 0 if either counter is missing
+    double ipc() const;
+
+    // Function to get the report name of a counter
+    static const char* counterName(Counter counter);
+};
+
+// Set of Linux perf_event counters for the calling thread and any threads it spawns.
+// On other platforms, or when perf_event_open is denied, isAvailable() is false and
+// stop() returns an invalid sample so callers fall back to timing only.
+class PerfCounterGroup {
+public:
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    bool isAvailable() const { return available_; }
+
+    // Human-readable reason when the counters could not be opened
+    const std::string& unavailableReason() const { return unavailableReason_; }
+
+    void start();
+    PerfCounterSample stop();
+
+private:
+    int fds_[PerfCounterSample::CounterCount];
+    bool available_ = false;
+    std::string unavailableReason_;
+};
+
+#endif // PERF_COUNTERS_H
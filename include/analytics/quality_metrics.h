@@ -0,0 +1,21 @@
+#ifndef QUALITY_METRICS_H
+#define QUALITY_METRICS_H
+
+#include <cstdint>
+#include <vector>
+#include "../image/image_buffer.h"
+
+// Error metrics between an original RGBA image and its decoded counterpart
+struct QualityMetrics {
+    double rgbMSE = 0.0;    // Mean squared error over the R, G and B channels
+    double rgbPSNR = 0.0;   // Peak signal-to-noise ratio in dB (infinity for identical images)
+    double alphaMSE = 0.0;  // Mean squared error of the alpha channel
+    double alphaPSNR = 0.0; // Alpha PSNR in dB (infinity for identical alpha)
+    int maxError = 0;       // Largest absolute per-channel difference
+};
+
+// Function to compare an image (any channel layout) with its decoded RGBA counterpart
+// (tightly packed, same dimensions)
+QualityMetrics computeQualityMetrics(const ImageView& original, const uint8_t* decoded);
+
+#endif // QUALITY_METRICS_H
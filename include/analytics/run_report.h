@@ -0,0 +1,69 @@
+#ifndef RUN_REPORT_H
+#define RUN_REPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "perf_counters.h"
+#include "quality_metrics.h"
+
+// One input x algorithm result of a processing run
+struct RunReportRow {
+    std::string inputFile;
+    std::string algorithm;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    int mipLevels = 1; // Levels in the compressed output (--mips writes the full chain)
+    double encodeSeconds = 0.0;
+    double decodeSeconds = 0.0;
+    size_t compressedBytes = 0;
+    bool decoded = false;  // Quality metrics are only meaningful when the output was decoded
+    bool cacheHit = false; // Outputs were restored from the output cache; nothing was encoded
+    uint64_t dedupeLookups = 0; // Blocks encoded through the block dedupe table (0 when --dedupe is off)
+    uint64_t dedupeHits = 0;
+    bool sequenceFrame = false; // Encoded by the temporal sequence encoder (--sequence)
+    uint64_t sequenceReusedExact = 0;
+    uint64_t sequenceReusedWithinError = 0;
+    uint64_t sequenceEncodedBlocks = 0;
+    QualityMetrics quality;
+    PerfCounterSample encodeCounters; // Only valid when hardware counters were captured
+    PerfCounterSample decodeCounters;
+
+    // Derived values
+    double encodeMegapixelsPerSecond() const;
+    double decodeMegapixelsPerSecond() const;
+    double bitsPerPixel() const;
+    double compressionRatio() const; // Raw RGBA bytes / compressed bytes
+    double dedupeHitRate() const;
+};
+
+// Collects rows for a whole run and serialises them once at the end
+class RunReport {
+public:
+    RunReport();
+
+    void addRow(const RunReportRow& row);
+    const std::vector<RunReportRow>& rows() const { return rows_; }
+
+    // Function to record the total wall time of the run
+    void setTotalSeconds(double seconds) { totalSeconds_ = seconds; }
+
+    // Function to add a run-level counter (e.g. cache hits) to the summary
+    void addSummaryCounter(const std::string& name, uint64_t value);
+
+    // Function to write the report, choosing CSV for a ".csv" extension and JSON otherwise
+    bool write(const std::string& filePath) const;
+    bool writeJSON(const std::string& filePath) const;
+    bool writeCSV(const std::string& filePath) const;
+
+private:
+    std::vector<RunReportRow> rows_;
+    std::string startedAt_;
+    double totalSeconds_ = 0.0;
+    std::vector<std::pair<std::string, uint64_t>> summaryCounters_;
+};
+
+#endif // RUN_REPORT_H
@@ -0,0 +1,55 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// Chrome/Perfetto timeline tracing.
+//
+// Zones are only compiled in when TCA_ENABLE_TRACING is defined (CMake option
+// ENABLE_TRACING); otherwise TRACE_SCOPE expands to nothing. Each thread records
+// into its own fixed-size ring buffer, so recording takes no locks; when a buffer
+// wraps, the oldest events of that thread are dropped. The buffer of an exited
+// thread passes to the next thread that records, so the number of buffers (and
+// timeline tracks) stays at the peak number of threads alive at once.
+
+// Function to start recording; zones entered before this call are ignored
+void traceStart();
+
+// Function to name the calling thread in the timeline
+void traceSetThreadName(const std::string& name);
+
+// Function to write everything recorded so far as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+// Returns false if the file cannot be written or tracing was compiled out.
+bool traceWriteChromeJSON(const std::string& filePath);
+
+// Function to tell whether zones are compiled in
+bool traceCompiledIn();
+
+#if defined(TCA_ENABLE_TRACING)
+
+// Records one complete event from construction to destruction. The name must outlive the trace.
+class TraceScope {
+public:
+    explicit TraceScope(const char* name);
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t startNanoseconds_;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+#else
+
+#define TRACE_SCOPE(name) do { } while (0)
+
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,60 @@
+#ifndef OUTPUT_CACHE_H
+#define OUTPUT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../compression/compression_algorithm.h"
+#include "../image/image_buffer.h"
+
+// Counters shown in the run summary
+struct OutputCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t stores = 0;
+    uint64_t linkedFiles = 0; // Outputs restored as hard links
+    uint64_t copiedFiles = 0; // Outputs restored by copying (hard links unsupported)
+    uint64_t bytesRestored = 0;
+};
+
+// What the run report records for an entry, stored with it so a hit reports the same row as the
+// run that encoded it
+struct OutputCacheEntryInfo {
+    size_t compressedBytes = 0; // Block data of every level, without container header or supercompression
+    int mipLevels = 1;
+};
+
+// Persistent content-addressed store of encoder outputs.
+//
+// Entries are keyed by a hash of the decoded pixels, the dimensions, the
+// algorithm, the encoder version and the encoder settings, so any change to
+// one of those misses. Each entry holds the .compressed result, the decoded
+// verification PNG and an .info file with the OutputCacheEntryInfo under
+// <directory>/<first two hex digits>/<key>.
+class OutputCache {
+public:
+    explicit OutputCache(const std::string& directory);
+
+    // Function to hash decoded pixels once per input (row padding is not hashed)
+    static uint64_t hashPixels(const ImageView& image);
+
+    // Function to compute the cache key of one input x algorithm pair
+    static uint64_t computeKey(uint64_t pixelHash, int width, int height, CompressionAlgorithm algorithm, const std::string& settings);
+
+    // Function to place a cached entry at the output paths and read its info. Returns false on a miss.
+    bool restore(uint64_t key, const std::string& compressedFilePath, const std::string& decodedFilePath, OutputCacheEntryInfo& info);
+
+    // Function to add freshly written outputs to the cache
+    void store(uint64_t key, const std::string& compressedFilePath, const std::string& decodedFilePath, const OutputCacheEntryInfo& info);
+
+    const OutputCacheStats& stats() const { return stats_; }
+
+private:
+    std::string entryPath(uint64_t key, const char* extension) const;
+
+    std::string directory_;
+    OutputCacheStats stats_;
+};
+
+#endif // OUTPUT_CACHE_H
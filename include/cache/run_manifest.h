@@ -0,0 +1,58 @@
+#ifndef RUN_MANIFEST_H
+#define RUN_MANIFEST_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// One output file produced for an input
+struct ManifestOutput {
+    std::string path;
+    uint64_t size = 0;
+    int64_t modifiedTime = 0; // Filesystem clock ticks
+};
+
+// What the last run saw of one input file and what it wrote for it
+struct ManifestEntry {
+    uint64_t inputSize = 0;
+    int64_t inputModifiedTime = 0; // Filesystem clock ticks
+    std::vector<ManifestOutput> outputs;
+};
+
+// Persisted record of the previous run in an output directory, used to skip
+// inputs whose size and modification time are unchanged without decoding them.
+class RunManifest {
+public:
+    // Function to load a manifest; a missing or unreadable file yields an empty manifest
+    bool load(const std::string& filePath);
+
+    // Function to write the manifest atomically (temporary file + rename)
+    bool save(const std::string& filePath) const;
+
+    // Settings fingerprint (encoder version + settings) the entries were produced with
+    const std::string& settings() const { return settings_; }
+    void setSettings(const std::string& settings) { settings_ = settings; }
+
+    // Function to check whether an input is unchanged and all of its recorded outputs are still present
+    // with the size and modification time they were written with
+    bool isUpToDate(const std::string& inputPath, uint64_t inputSize, int64_t inputModifiedTime) const;
+
+    const ManifestEntry* find(const std::string& inputPath) const;
+    void set(const std::string& inputPath, const ManifestEntry& entry);
+
+    // Function to delete the outputs of inputs that no longer exist; returns the number of files removed
+    size_t removeOutputsOfMissingInputs();
+
+    // Function to describe an output file that was just written; a stat, the contents are not read
+    static ManifestOutput describeOutput(const std::string& path);
+
+    // Function to read a file's size and modification time; returns false if it cannot be stat'ed
+    static bool statInput(const std::string& path, uint64_t& size, int64_t& modifiedTime);
+
+private:
+    std::string settings_;
+    std::map<std::string, ManifestEntry> entries_;
+};
+
+#endif // RUN_MANIFEST_H
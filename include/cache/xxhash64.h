@@ -0,0 +1,28 @@
+#ifndef XXHASH64_H
+#define XXHASH64_H
+
+#include <cstddef>
+#include <cstdint>
+
+// In-tree implementation of the XXH64 hash (same output as the reference xxHash library)
+
+// Function to hash a buffer in one call
+uint64_t xxHash64(const void* data, size_t length, uint64_t seed = 0);
+
+// Streaming state for hashing data that arrives in pieces (e.g. image rows)
+class XXHash64 {
+public:
+    explicit XXHash64(uint64_t seed = 0);
+
+    void update(const void* data, size_t length);
+    uint64_t digest() const;
+
+private:
+    uint64_t accumulators_[4];
+    uint64_t seed_;
+    uint64_t totalLength_;
+    unsigned char buffer_[32];
+    size_t bufferSize_;
+};
+
+#endif // XXHASH64_H
@@ -0,0 +1,46 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "compression_algorithm.h"
+#include "../image/image_buffer.h"
+
+// Table entry describing the kernels of an implemented block format
+struct BlockCodec {
+    CompressionAlgorithm algorithm;
+    const char* name;
+    int blockBytes;
+
+    void (*compressBlock)(const uint8_t* block, uint8_t* output);
+    void (*decompressBlock)(const uint8_t* input, uint8_t* block);
+    void (*compressBlockRows)(const ImageView& image, int firstBlockRow, int lastBlockRow, uint8_t* compressedData);
+    void (*decompressBlockRows)(const uint8_t* compressedData, int width, int height, int firstBlockRow, int lastBlockRow, uint8_t* textureData);
+    bool (*recompressRegion)(const ImageView& image, int regionX, int regionY, int regionWidth, int regionHeight, std::vector<uint8_t>& compressedData);
+};
+
+// Function to list every implemented block format
+const std::vector<BlockCodec>& getBlockCodecs();
+
+// Function to look up the codec of an algorithm, or nullptr if it is not implemented
+const BlockCodec* findBlockCodec(CompressionAlgorithm algorithm);
+
+// Function to get the compressed size of a width x height image in bytes
+size_t getCompressedSize(const BlockCodec& codec, int width, int height);
+
+// Functions to run a codec over a whole image, splitting block rows across threadCount threads
+void compressImageParallel(const BlockCodec& codec, const ImageView& image, std::vector<uint8_t>& compressedData, int threadCount);
+void decompressImageParallel(const BlockCodec& codec, const std::vector<uint8_t>& compressedData, int width, int height, std::vector<uint8_t>& textureData, int threadCount);
+
+// Function to encode into caller memory of getCompressedSize bytes (e.g. a huge-page buffer)
+void compressImageParallel(const BlockCodec& codec, const ImageView& image, uint8_t* compressedData, int threadCount);
+
+// Function to decode block data that lives outside a vector (e.g. a memory-mapped container)
+void decompressImageParallel(const BlockCodec& codec, const uint8_t* compressedData, size_t compressedBytes, int width, int height, std::vector<uint8_t>& textureData, int threadCount);
+
+// Function to decode into caller memory of width * height * 4 bytes. Every texel is written, so
+// the memory needs no zero-fill. Returns false if the block data is too small.
+bool decompressImageParallel(const BlockCodec& codec, const uint8_t* compressedData, size_t compressedBytes, int width, int height, uint8_t* textureData, int threadCount);
+
+#endif // BLOCK_CODEC_H
@@ -0,0 +1,63 @@
+#ifndef BLOCK_DEDUPE_CACHE_H
+#define BLOCK_DEDUPE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "block_codec.h"
+
+// Default table size: 2^16 slots of 96 bytes (6 MiB), enough for the distinct blocks of a 1024x1024 texture
+const int BLOCK_DEDUPE_DEFAULT_CAPACITY_LOG2 = 16;
+
+// Lookup counters of a dedupe pass
+struct BlockDedupeStats {
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+
+    double hitRate() const { return lookups ? static_cast<double>(hits) / lookups : 0.0; }
+};
+
+// Fixed-size open-addressing table from raw 4x4 RGBA blocks to their encoded bytes.
+//
+// Only exact matches of all 64 source bytes are reused, so the output is identical to
+// encoding every block. Entries are keyed on the algorithm as well, so one table can be
+// shared by every format and every texture of a batch. When a probe sequence is full its
+// home slot is overwritten. Not thread-safe.
+class BlockDedupeCache {
+public:
+    explicit BlockDedupeCache(int capacityLog2 = BLOCK_DEDUPE_DEFAULT_CAPACITY_LOG2);
+
+    // Function to encode one block through the table: copies the stored result on a hit,
+    // otherwise runs the codec kernel and remembers its output. Returns true on a hit.
+    bool compressBlock(const BlockCodec& codec, const uint8_t* block, uint8_t* output);
+
+    // Function to forget every entry (constant time)
+    void clear();
+
+    size_t capacity() const { return tags_.size(); }
+    const BlockDedupeStats& stats() const { return stats_; } // Totals since construction
+
+private:
+    // Probed on every lookup, so kept apart from the payload: four tags per cache line
+    struct SlotTag {
+        uint64_t hash;
+        uint32_t generation; // Slot is live when it matches generation_
+        uint32_t algorithm;
+    };
+    struct SlotPayload {
+        uint8_t block[64];
+        uint8_t encoded[16];
+    };
+
+    std::vector<SlotTag> tags_;
+    std::vector<SlotPayload> payloads_;
+    size_t mask_;
+    uint32_t generation_ = 1;
+    BlockDedupeStats stats_;
+};
+
+// Function to compress a whole image through a dedupe table on the calling thread.
+// Returns the lookups and hits of this image alone.
+BlockDedupeStats compressImageDeduplicated(const BlockCodec& codec, const ImageView& image, std::vector<uint8_t>& compressedData, BlockDedupeCache& cache);
+
+#endif // BLOCK_DEDUPE_CACHE_H
@@ -0,0 +1,28 @@
+#ifndef COMPRESSION_ALGORITHM_H
+#define COMPRESSION_ALGORITHM_H
+
+#include <string>
+
+// Enum for different compression algorithms
+enum class CompressionAlgorithm {
+    DXT1, DXT2, DXT3, DXT4, DXT5,
+    ASTC_LDR, ASTC_HDR,
+    ETC1, ETC2,
+    PVRTC1, PVRTC2,
+    BC1, BC2, BC3, BC4, BC5, BC6H, BC7
+};
+
+// Function to get the display name of a compression algorithm
+inline std::string getAlgorithmName(CompressionAlgorithm algorithm) {
+    switch (algorithm) {
+        case CompressionAlgorithm::DXT1:
+            return "DXT1";
+        case CompressionAlgorithm::DXT2:
+            return "DXT2";
+        // Add other cases as needed
+        default:
+            return "Unknown";
+    }
+}
+
+#endif // COMPRESSION_ALGORITHM_H
@@ -0,0 +1,54 @@
+#ifndef SEQUENCE_ENCODER_H
+#define SEQUENCE_ENCODER_H
+
+#include <cstdint>
+#include <vector>
+#include "block_codec.h"
+#include "block_dedupe_cache.h"
+
+// Block counts of one encoded frame
+struct SequenceFrameStats {
+    uint64_t blocks = 0;
+    uint64_t reusedExact = 0;       // Source block identical to the reference; bytes copied
+    uint64_t reusedWithinError = 0; // Source block within maxBlockError of the reference; bytes copied
+    uint64_t encoded = 0;           // Changed blocks run through the codec
+
+    uint64_t reused() const { return reusedExact + reusedWithinError; }
+};
+
+// Encoder for ordered frames of a flipbook or video texture.
+//
+// Each block of a frame is compared with the reference block, the source texels that
+// produced the block's current encoding. If they are identical, or no channel differs by
+// more than maxBlockError, the previous frame's encoded bytes are kept; otherwise the block
+// is encoded and becomes the new reference. Comparing against the encoded source rather
+// than the previous frame keeps slow changes from drifting past the error bound.
+//
+// With maxBlockError 0 the output is byte-identical to encoding every frame on its own.
+class SequenceEncoder {
+public:
+    SequenceEncoder(const BlockCodec& codec, int width, int height, int maxBlockError = 0);
+
+    // Function to encode the next frame, which must be width x height. Changed blocks go
+    // through dedupeCache when one is given.
+    SequenceFrameStats encodeFrame(const ImageView& frame, std::vector<uint8_t>& compressedData,
+                                   BlockDedupeCache* dedupeCache = nullptr);
+
+    // Function to start a new sequence; the next frame is encoded in full
+    void reset() { hasReference_ = false; }
+
+    const BlockCodec& codec() const { return codec_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+private:
+    const BlockCodec& codec_;
+    int width_;
+    int height_;
+    int maxBlockError_;
+    bool hasReference_ = false;
+    std::vector<uint8_t> referenceBlocks_; // 64 bytes per block
+    std::vector<uint8_t> encodedFrame_;    // Encoding of the last frame
+};
+
+#endif // SEQUENCE_ENCODER_H
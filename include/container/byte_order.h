@@ -0,0 +1,34 @@
+#ifndef BYTE_ORDER_H
+#define BYTE_ORDER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Little-endian header fields shared by the container readers and writers, read and written a
+// byte at a time so the files are the same on any host byte order.
+
+// Function to store a 32-bit value at a byte offset
+inline void putU32(uint8_t* bytes, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        bytes[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+// Function to store a 64-bit value at a byte offset
+inline void putU64(uint8_t* bytes, size_t offset, uint64_t value) {
+    putU32(bytes, offset, static_cast<uint32_t>(value));
+    putU32(bytes, offset + 4, static_cast<uint32_t>(value >> 32));
+}
+
+// Function to load a 32-bit value from a byte offset
+inline uint32_t getU32(const uint8_t* bytes, size_t offset) {
+    return static_cast<uint32_t>(bytes[offset]) | (static_cast<uint32_t>(bytes[offset + 1]) << 8) |
+           (static_cast<uint32_t>(bytes[offset + 2]) << 16) | (static_cast<uint32_t>(bytes[offset + 3]) << 24);
+}
+
+// Function to load a 64-bit value from a byte offset
+inline uint64_t getU64(const uint8_t* bytes, size_t offset) {
+    return static_cast<uint64_t>(getU32(bytes, offset)) | (static_cast<uint64_t>(getU32(bytes, offset + 4)) << 32);
+}
+
+#endif // BYTE_ORDER_H
@@ -0,0 +1,55 @@
+#ifndef DDS_H
+#define DDS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "mapped_file.h"
+#include "../compression/compression_algorithm.h"
+
+// Shape of the surfaces stored in a DDS file
+struct DDSDescription {
+    CompressionAlgorithm algorithm = CompressionAlgorithm::DXT1;
+    int width = 0;
+    int height = 0;
+    int mipLevels = 1;
+    int arraySize = 1;       // Array layers, at most MAX_TEXTURE_LAYERS; more than 1 requires the DX10 header
+    bool cubeMap = false;    // Each layer is six faces (+X, -X, +Y, -Y, +Z, -Z)
+    bool dx10Header = false; // Write the DX10 extension header (DXGI format) instead of a FourCC alone
+
+    int surfaceCount() const { return arraySize * (cubeMap ? 6 : 1); }
+};
+
+// Function to check that a description can be written (format, dimensions, mip count, header)
+bool isDDSDescriptionValid(const DDSDescription& description);
+
+// Function to get the size of the block data: every surface with its whole mip chain (SIZE_MAX
+// if that does not fit in size_t)
+size_t getDDSPayloadBytes(const DDSDescription& description);
+
+// Function to write a DDS file. The payload holds the block data in DDS order: for each layer
+// (and face), every mip level from largest to smallest.
+bool writeDDS(const std::string& filePath, const DDSDescription& description, const uint8_t* payload, size_t payloadBytes);
+
+// Memory-mapped DDS reader. Surfaces point straight into the mapping and stay valid until
+// the file is closed. The legacy BC1 to BC3 FourCCs and DXGI formats are reported as
+// DXT1/DXT3/DXT5 (DXT2/DXT4 when marked premultiplied).
+class DDSFile {
+public:
+    // Function to map and validate a file. Returns false if it is missing, truncated or unsupported,
+    // or larger than MAX_TEXTURE_DIMENSION or MAX_TEXTURE_LAYERS.
+    bool open(const std::string& filePath);
+    void close() { file_.close(); }
+
+    const DDSDescription& description() const { return description_; }
+
+    // Function to get the block data of one mip level of a surface (layer * 6 + face for cube maps)
+    const uint8_t* surface(int surfaceIndex, int mipLevel, size_t& bytes) const;
+
+private:
+    MappedFile file_;
+    DDSDescription description_;
+    size_t payloadOffset_ = 0;
+};
+
+#endif // DDS_H
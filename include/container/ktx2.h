@@ -0,0 +1,75 @@
+#ifndef KTX2_H
+#define KTX2_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "../compression/compression_algorithm.h"
+
+// Supercompression scheme of the in-tree LZ stage (lz_block.h). KTX2 reserves 0x10000-0x1FFFF
+// for vendor schemes, so loaders other than this one reject these files; files written without
+// supercompression are standard KTX2.
+const uint32_t KTX2_SUPERCOMPRESSION_NONE = 0;
+const uint32_t KTX2_SUPERCOMPRESSION_LZ_BLOCK = 0x10000;
+
+// Shape of the images stored in a KTX2 file
+struct KTX2Description {
+    CompressionAlgorithm algorithm = CompressionAlgorithm::DXT1;
+    int width = 0;
+    int height = 0;
+    int mipLevels = 1;
+    int layerCount = 0; // 0 for a plain texture, 1 up to MAX_TEXTURE_LAYERS for an array texture
+    int faceCount = 1;  // 6 for a cube map
+    uint32_t supercompressionScheme = KTX2_SUPERCOMPRESSION_NONE;
+
+    int imageCount() const { return (layerCount > 0 ? layerCount : 1) * faceCount; }
+};
+
+// Function to check that a description can be written (format, dimensions, mip count, faces)
+bool isKTX2DescriptionValid(const KTX2Description& description);
+
+// Function to get the block data size of one mip level across every layer and face (SIZE_MAX if
+// that does not fit in size_t)
+size_t getKTX2LevelBytes(const KTX2Description& description, int mipLevel);
+
+// Function to write a KTX2 file. The payload holds the block data level by level, largest
+// first, and within a level layer by layer and face by face. With the LZ scheme every level is
+// compressed on its own (in parallel), so readers can expand levels independently.
+bool writeKTX2(const std::string& filePath, const KTX2Description& description, const uint8_t* payload, size_t payloadBytes,
+               int threadCount = 0);
+
+// Memory-mapped KTX2 reader
+class KTX2File {
+public:
+    // Function to map and validate a file and its level index. Returns false if it is missing,
+    // truncated or unsupported, or larger than MAX_TEXTURE_DIMENSION or MAX_TEXTURE_LAYERS.
+    bool open(const std::string& filePath);
+    void close() { file_.close(); }
+
+    const KTX2Description& description() const { return description_; }
+
+    // Function to get the block data of a mip level (every layer and face). Uncompressed levels
+    // point into the mapping; supercompressed levels are expanded into scratch.
+    const uint8_t* levelData(int mipLevel, std::vector<uint8_t>& scratch) const;
+
+    // Function to expand every level, one level per thread. Returns false if a level is corrupt.
+    bool readAllLevels(std::vector<std::vector<uint8_t>>& levels, int threadCount = 0) const;
+
+    // Function to get the offset of one image (layer * faceCount + face) within its level's data
+    size_t imageOffset(int mipLevel, int imageIndex) const;
+
+private:
+    struct LevelEntry {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    MappedFile file_;
+    KTX2Description description_;
+    std::vector<LevelEntry> levels_;
+};
+
+#endif // KTX2_H
@@ -0,0 +1,19 @@
+#ifndef LZ_BLOCK_H
+#define LZ_BLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// In-tree LZ compressor for container payloads, producing the LZ4 block format (no frame
+// header or checksum). Decoding is a byte-oriented copy loop, fast enough to run per mip
+// level while a texture loads.
+
+// Function to compress a buffer, replacing the contents of output
+void lzCompress(const uint8_t* input, size_t inputBytes, std::vector<uint8_t>& output);
+
+// Function to decompress exactly outputBytes bytes. Returns false on malformed or truncated
+// input, or if the data does not expand to exactly outputBytes.
+bool lzDecompress(const uint8_t* input, size_t inputBytes, uint8_t* output, size_t outputBytes);
+
+#endif // LZ_BLOCK_H
@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. On POSIX systems the file is memory-mapped, so readers
+// hand pointers into the page cache to the decoders without copying; elsewhere it is read
+// into an owned buffer.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Function to map a file, replacing any previous mapping. Returns false if it cannot be read.
+    bool open(const std::string& filePath);
+    void close();
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return data_ != nullptr; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;         // data_ came from mmap and must be unmapped
+    std::vector<uint8_t> buffer_; // Fallback storage when mapping is unavailable
+};
+
+#endif // MAPPED_FILE_H
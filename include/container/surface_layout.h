@@ -0,0 +1,65 @@
+#ifndef SURFACE_LAYOUT_H
+#define SURFACE_LAYOUT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "../compression/compression_algorithm.h"
+
+// Size helpers shared by the texture containers. Every format here uses 4x4 blocks.
+
+// Largest width, height and layer count the readers accept (the Direct3D 11 limits). Header
+// counts are untrusted; these bounds keep every size derived from them far from overflow.
+const int MAX_TEXTURE_DIMENSION = 16384;
+const int MAX_TEXTURE_LAYERS = 2048;
+
+// Function to multiply two sizes, saturating at SIZE_MAX instead of wrapping around. No file is
+// that large, so a saturated size always fails the comparison against the file size.
+inline size_t multiplySizes(size_t a, size_t b) {
+    return a != 0 && b > SIZE_MAX / a ? SIZE_MAX : a * b;
+}
+
+// Function to get the bytes per block of a format, or 0 if the containers do not support it
+inline int getFormatBlockBytes(CompressionAlgorithm algorithm) {
+    switch (algorithm) {
+        case CompressionAlgorithm::DXT1:
+        case CompressionAlgorithm::BC1:
+        case CompressionAlgorithm::BC4:
+            return 8;
+        case CompressionAlgorithm::DXT2:
+        case CompressionAlgorithm::DXT3:
+        case CompressionAlgorithm::DXT4:
+        case CompressionAlgorithm::DXT5:
+        case CompressionAlgorithm::BC2:
+        case CompressionAlgorithm::BC3:
+        case CompressionAlgorithm::BC5:
+        case CompressionAlgorithm::BC6H:
+        case CompressionAlgorithm::BC7:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+// Function to get a dimension of a mip level
+inline int getMipDimension(int baseSize, int mipLevel) {
+    return std::max(1, baseSize >> mipLevel);
+}
+
+// Function to get the byte size of one mip level of one surface
+inline size_t getMipSurfaceBytes(CompressionAlgorithm algorithm, int width, int height, int mipLevel) {
+    size_t blocksX = (static_cast<size_t>(getMipDimension(width, mipLevel)) + 3) / 4;
+    size_t blocksY = (static_cast<size_t>(getMipDimension(height, mipLevel)) + 3) / 4;
+    return blocksX * blocksY * getFormatBlockBytes(algorithm);
+}
+
+// Function to check a mip count against the dimensions (1 up to a full chain down to 1x1)
+inline bool isValidMipCount(int width, int height, int mipLevels) {
+    int fullChain = 1;
+    for (int size = std::max(width, height); size > 1; size /= 2) {
+        ++fullChain;
+    }
+    return mipLevels >= 1 && mipLevels <= fullChain;
+}
+
+#endif // SURFACE_LAYOUT_H
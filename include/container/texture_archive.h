@@ -0,0 +1,112 @@
+#ifndef TEXTURE_ARCHIVE_H
+#define TEXTURE_ARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+#include "mapped_file.h"
+#include "../compression/compression_algorithm.h"
+
+// Packed output archive: every output of a run in one file instead of one file per input and
+// algorithm. Payloads are stored back to back, each aligned to ARCHIVE_DATA_ALIGNMENT, followed
+// by a fixed-size index sorted by name hash and a table of the names. Readers map the file and
+// binary search the index in place, so a lookup neither parses nor copies anything.
+
+const size_t ARCHIVE_DATA_ALIGNMENT = 64;
+const size_t ARCHIVE_DEFAULT_BUFFER_BYTES = 8 << 20;
+
+// What an entry's payload holds
+enum class ArchiveEntryKind : uint32_t {
+    Blocks = 0, // Block compressed data; mip levels back to back, base level first
+    PNG = 1     // An encoded PNG image (algorithm is the codec that produced the pixels)
+};
+
+// Metadata stored in the index with each entry
+struct ArchiveEntryInfo {
+    ArchiveEntryKind kind = ArchiveEntryKind::Blocks;
+    CompressionAlgorithm algorithm = CompressionAlgorithm::DXT1;
+    int width = 0;
+    int height = 0;
+    int mipLevels = 1;
+};
+
+// One entry of an open archive; name and data point into the mapping
+struct ArchiveEntry {
+    std::string_view name;
+    ArchiveEntryInfo info;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+// Writer appending entries through one large buffer. The archive is assembled under a temporary
+// name and renamed into place by finish(), so an interrupted run never leaves a truncated archive.
+class TextureArchiveWriter {
+public:
+    TextureArchiveWriter() = default;
+    ~TextureArchiveWriter();
+    TextureArchiveWriter(const TextureArchiveWriter&) = delete;
+    TextureArchiveWriter& operator=(const TextureArchiveWriter&) = delete;
+
+    // Function to start a new archive. Returns false if the file cannot be created.
+    bool open(const std::string& filePath, size_t bufferBytes = ARCHIVE_DEFAULT_BUFFER_BYTES);
+
+    // Function to append an entry. Returns false for a duplicate name or a failed write.
+    bool add(const std::string& name, const ArchiveEntryInfo& info, const uint8_t* data, size_t size);
+
+    // Function to write the index and name table and publish the archive
+    bool finish();
+
+    size_t entryCount() const { return entries_.size(); }
+    uint64_t bytesWritten() const { return position_; }
+
+private:
+    struct PendingEntry {
+        std::string name;
+        ArchiveEntryInfo info;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    bool append(const uint8_t* data, size_t size);
+    bool pad(size_t alignment);
+    bool flush();
+    void abandon();
+
+    std::string filePath_;
+    std::string temporaryPath_;
+    std::ofstream file_;
+    std::vector<uint8_t> buffer_;
+    size_t bufferUsed_ = 0;
+    uint64_t position_ = 0; // Bytes appended so far, including those still in the buffer
+    bool failed_ = false;
+    std::vector<PendingEntry> entries_;
+    std::unordered_set<std::string> names_;
+};
+
+// Memory-mapped archive reader
+class TextureArchive {
+public:
+    // Function to map and validate an archive. Returns false if it is missing, truncated or corrupt.
+    bool open(const std::string& filePath);
+    void close() { file_.close(); }
+
+    size_t size() const { return entryCount_; }
+
+    // Function to get the entry at an index position (entries are in name hash order)
+    ArchiveEntry entry(size_t index) const;
+
+    // Function to look up an entry by name. Returns false if the archive has no such entry.
+    bool find(std::string_view name, ArchiveEntry& entry) const;
+
+private:
+    MappedFile file_;
+    size_t entryCount_ = 0;
+    const uint8_t* index_ = nullptr;
+    const uint8_t* names_ = nullptr;
+};
+
+#endif // TEXTURE_ARCHIVE_H
@@ -0,0 +1,36 @@
+#ifndef SYNTHETIC_TEXTURE_H
+#define SYNTHETIC_TEXTURE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Content types of the generated test corpus
+enum class SyntheticPattern {
+    Gradient,     // Smooth diagonal gradient between two colors
+    Checkerboard, // Hard-edged two-color checkerboard
+    ValueNoise,   // Multi-octave value noise per channel
+    FlatAtlas,    // Grid of flat-colored rectangles, like UI art atlases
+    NormalMap,    // Tangent-space normals derived from a noise height field
+    SharpAlpha,   // Noise color with a binary cut-out alpha
+    SmoothAlpha   // Gradient color with a smoothly varying alpha
+};
+
+// Smallest and largest generated dimensions
+const int SYNTHETIC_MIN_SIZE = 4;
+const int SYNTHETIC_MAX_SIZE = 32768;
+
+// Function to list every pattern in a stable order
+const std::vector<SyntheticPattern>& getSyntheticPatterns();
+
+// Function to get the short name of a pattern (as accepted by parseSyntheticPattern)
+std::string getSyntheticPatternName(SyntheticPattern pattern);
+
+// Function to parse a pattern name, returning false if it is unknown
+bool parseSyntheticPattern(const std::string& name, SyntheticPattern& pattern);
+
+// Function to generate an RGBA texture. The output depends only on pattern, size and seed,
+// never on threadCount (0 selects the hardware concurrency).
+std::vector<uint8_t> generateSyntheticTexture(SyntheticPattern pattern, int width, int height, uint64_t seed, int threadCount = 0);
+
+#endif // SYNTHETIC_TEXTURE_H
@@ -0,0 +1,129 @@
+#ifndef BLOCK_IO_H
+#define BLOCK_IO_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "../image/image_buffer.h"
+#include "../simd/simd.h"
+
+inline namespace TCA_ISA_NAMESPACE {
+
+// Function to copy the 4x4 block at (x, y) of a Channels-channel image into 16 RGBA texels.
+// Texels outside the image are padded with opaque black.
+template <int Channels>
+inline void extractBlock(const ImageView& image, int x, int y, uint8_t* block) {
+    for (int j = 0; j < 4; ++j) {
+        uint8_t* row = block + j * 16;
+        int srcY = y + j;
+        int columns = srcY < image.height ? (image.width - x < 4 ? image.width - x : 4) : 0;
+        if (columns > 0) {
+            const uint8_t* source = image.data + static_cast<size_t>(srcY) * image.stride + static_cast<size_t>(x) * Channels;
+            if (Channels == 4) {
+                std::memcpy(row, source, columns * 4);
+            } else {
+                expandTexels<Channels>(source, columns, row);
+            }
+        }
+        for (int i = columns; i < 4; ++i) {
+            row[i * 4 + 0] = 0;
+            row[i * 4 + 1] = 0;
+            row[i * 4 + 2] = 0;
+            row[i * 4 + 3] = 255;
+        }
+    }
+}
+
+// Function to copy the 4x4 block at (x, y) into 16 RGBA texels, whatever the image layout
+inline void extractBlock(const ImageView& image, int x, int y, uint8_t* block) {
+    switch (image.channels) {
+        case 1: extractBlock<1>(image, x, y, block); break;
+        case 2: extractBlock<2>(image, x, y, block); break;
+        case 3: extractBlock<3>(image, x, y, block); break;
+        default: extractBlock<4>(image, x, y, block); break;
+    }
+}
+
+// Function to copy 16 decoded RGBA texels back into the image at (x, y), clipping at the edges
+inline void storeBlock(const uint8_t* block, int width, int height, int x, int y, uint8_t* textureData) {
+    for (int j = 0; j < 4; ++j) {
+        int dstY = y + j;
+        if (dstY >= height) {
+            break;
+        }
+        int columns = width - x < 4 ? width - x : 4;
+        size_t dstIndex = (static_cast<size_t>(dstY) * width + x) * 4;
+        std::memcpy(textureData + dstIndex, block + j * 16, columns * 4);
+    }
+}
+
+// Helper function returning the number of 4x4 blocks needed to cover a dimension
+inline int blockCount(int pixels) {
+    return (pixels + 3) / 4;
+}
+
+// Function to re-encode, in place, only the blocks of an existing compressed image that overlap
+// the rectangle (regionX, regionY, regionWidth, regionHeight). The rectangle is clipped to the image.
+// Returns false if compressedData does not match the image dimensions.
+template <typename CompressBlock>
+inline bool compressBlockRegion(const ImageView& image, int regionX, int regionY, int regionWidth, int regionHeight,
+                                int blockBytes, std::vector<uint8_t>& compressedData, CompressBlock compressBlock) {
+    int width = image.width;
+    int height = image.height;
+    int blocksX = blockCount(width);
+    int blocksY = blockCount(height);
+    if (compressedData.size() != static_cast<size_t>(blocksX) * blocksY * blockBytes) {
+        return false;
+    }
+
+    int left = regionX < 0 ? 0 : regionX;
+    int top = regionY < 0 ? 0 : regionY;
+    int right = regionX + regionWidth > width ? width : regionX + regionWidth;
+    int bottom = regionY + regionHeight > height ? height : regionY + regionHeight;
+    if (left >= right || top >= bottom) {
+        return true; // Nothing to do
+    }
+
+    uint8_t block[64];
+    for (int by = top / 4; by < blockCount(bottom); ++by) {
+        for (int bx = left / 4; bx < blockCount(right); ++bx) {
+            extractBlock(image, bx * 4, by * 4, block);
+            compressBlock(block, &compressedData[(static_cast<size_t>(by) * blocksX + bx) * blockBytes]);
+        }
+    }
+    return true;
+}
+
+// Function to encode block rows [firstBlockRow, lastBlockRow) of a Channels-channel image
+template <int Channels, typename CompressBlock>
+inline void compressBlockRowsNative(const ImageView& image, int firstBlockRow, int lastBlockRow, int blockBytes,
+                                    uint8_t* compressedData, CompressBlock compressBlock) {
+    int blocksX = blockCount(image.width);
+    uint8_t block[64];
+    for (int by = firstBlockRow; by < lastBlockRow; ++by) {
+        uint8_t* output = compressedData + static_cast<size_t>(by) * blocksX * blockBytes;
+        for (int bx = 0; bx < blocksX; ++bx) {
+            extractBlock<Channels>(image, bx * 4, by * 4, block);
+            compressBlock(block, output);
+            output += blockBytes;
+        }
+    }
+}
+
+// Function to encode block rows with the loop specialized on the image's channel count.
+// Images without alpha (1 or 3 channels) go through compressOpaqueBlock, which may ignore
+// the alpha of the block entirely.
+template <typename CompressBlock, typename CompressOpaqueBlock>
+inline void compressBlockRows(const ImageView& image, int firstBlockRow, int lastBlockRow, int blockBytes, uint8_t* compressedData,
+                              CompressBlock compressBlock, CompressOpaqueBlock compressOpaqueBlock) {
+    switch (image.channels) {
+        case 1: compressBlockRowsNative<1>(image, firstBlockRow, lastBlockRow, blockBytes, compressedData, compressOpaqueBlock); break;
+        case 2: compressBlockRowsNative<2>(image, firstBlockRow, lastBlockRow, blockBytes, compressedData, compressBlock); break;
+        case 3: compressBlockRowsNative<3>(image, firstBlockRow, lastBlockRow, blockBytes, compressedData, compressOpaqueBlock); break;
+        default: compressBlockRowsNative<4>(image, firstBlockRow, lastBlockRow, blockBytes, compressedData, compressBlock); break;
+    }
+}
+
+} // namespace TCA_ISA_NAMESPACE
+
+#endif // BLOCK_IO_H
@@ -2,6 +2,38 @@
 #define COLOR_UTILS_H
 
 #include <cstdint>
+#include <cstring>
+#include <string>
+#include "dxt_block.h"
+#include "index_packing.h"
+#include "../simd/simd.h"
+
+// Table widening a Bits-bit channel to 8 bits. A plain array, since the kernels must not call
+// std::array's operator[] (see TCA_ISA_NAMESPACE in simd.h).
+template <int Bits>
+struct ExpandTable {
+    uint8_t values[1 << Bits];
+};
+
+inline namespace TCA_ISA_NAMESPACE {
+
+// Helper function building the table that widens a Bits-bit channel to 8 bits by bit replication
+template <int Bits>
+constexpr ExpandTable<Bits> makeExpandTable() {
+    ExpandTable<Bits> table{};
+    for (int v = 0; v < (1 << Bits); ++v) {
+        table.values[v] = static_cast<uint8_t>((v << (8 - Bits)) | (v >> (2 * Bits - 8)));
+    }
+    return table;
+}
+
+} // namespace TCA_ISA_NAMESPACE
+
+// 5- and 6-bit to 8-bit expansion, identical on every decoder
+constexpr ExpandTable<5> EXPAND5 = makeExpandTable<5>();
+constexpr ExpandTable<6> EXPAND6 = makeExpandTable<6>();
+
+inline namespace TCA_ISA_NAMESPACE {
 
 // Helper function to convert RGB to 565 format
 inline uint16_t rgbTo565(uint8_t r, uint8_t g, uint8_t b) {
@@ -10,13 +42,177 @@ inline uint16_t rgbTo565(uint8_t r, uint8_t g, uint8_t b) {
 
 // Helper function to convert 565 format to RGB
 inline void rgbFrom565(uint16_t color, uint8_t& r, uint8_t& g, uint8_t& b) {
-    r = (color >> 11) & 0x1F;
-    g = (color >> 5) & 0x3F;
-    b = color & 0x1F;
+    r = EXPAND5.values[(color >> 11) & 0x1F];
+    g = EXPAND6.values[(color >> 5) & 0x3F];
+    b = EXPAND5.values[color & 0x1F];
+}
+
+} // namespace TCA_ISA_NAMESPACE
+
+// Rounding of the interpolated palette entries. Hardware agrees on the endpoints but not on
+// the 1/3, 2/3 and 1/2 points in between; encoders pick indices against the palette of the
+// decoder they target.
+enum class DecoderProfile {
+    Legacy, // (2a + b) / 3 and (a + b) / 2 on 8-bit values, truncating (this tool before 1.2.0)
+    D3D10,  // Exact thirds and halves rounded to nearest, as the D3D10 reference decoder
+    NVIDIA, // Interpolates the 5-bit channels before expansion, green with a fixed-point weight
+    AMD     // (43a + 21b + 32) >> 6 and (a + b + 1) >> 1 on 8-bit values
+};
+
+// Interpolated channel values of one profile, indexed by the raw 5- or 6-bit endpoints
+struct PaletteTables {
+    uint8_t third5[32][32]; // [a][b]: one third of the way from a to b
+    uint8_t third6[64][64];
+    uint8_t half5[32][32];  // Midpoint of the DXT1 3-color mode
+    uint8_t half6[64][64];
+};
+
+// Function to get the command line name of a profile (as accepted by parseDecoderProfile)
+std::string getDecoderProfileName(DecoderProfile profile);
+
+// Function to parse a profile name, returning false if it is unknown
+bool parseDecoderProfile(const std::string& name, DecoderProfile& profile);
+
+// Function to select the profile every codec encodes for and decodes with (D3D10 by default).
+// Not synchronized: set it before starting any encode or decode.
+void setDecoderProfile(DecoderProfile profile);
+DecoderProfile getDecoderProfile();
+
+// Function to get the tables of a profile, or of the selected one
+const PaletteTables& getPaletteTables(DecoderProfile profile);
+const PaletteTables& getPaletteTables();
+
+inline namespace TCA_ISA_NAMESPACE {
 
-    r = (r << 3) | (r >> 2);
-    g = (g << 2) | (g >> 4);
-    b = (b << 3) | (b >> 2);
+// Function to build the RGBA palette of a color block the way the decoder profile does. In the
+// 4-color mode entries 2 and 3 lie at 1/3 and 2/3 between the endpoints; in the 3-color mode
+// (DXT1 with color0 <= color1) entry 2 is the midpoint and entry 3 transparent black.
+inline void buildPalette(const PaletteTables& tables, uint16_t color0, uint16_t color1, bool fourColor, uint8_t palette[4][4]) {
+    int r0 = (color0 >> 11) & 0x1F, g0 = (color0 >> 5) & 0x3F, b0 = color0 & 0x1F;
+    int r1 = (color1 >> 11) & 0x1F, g1 = (color1 >> 5) & 0x3F, b1 = color1 & 0x1F;
+
+    palette[0][0] = EXPAND5.values[r0];
+    palette[0][1] = EXPAND6.values[g0];
+    palette[0][2] = EXPAND5.values[b0];
+    palette[1][0] = EXPAND5.values[r1];
+    palette[1][1] = EXPAND6.values[g1];
+    palette[1][2] = EXPAND5.values[b1];
+    if (fourColor) {
+        palette[2][0] = tables.third5[r0][r1];
+        palette[2][1] = tables.third6[g0][g1];
+        palette[2][2] = tables.third5[b0][b1];
+        palette[3][0] = tables.third5[r1][r0];
+        palette[3][1] = tables.third6[g1][g0];
+        palette[3][2] = tables.third5[b1][b0];
+        palette[3][3] = 255;
+    } else {
+        palette[2][0] = tables.half5[r0][r1];
+        palette[2][1] = tables.half6[g0][g1];
+        palette[2][2] = tables.half5[b0][b1];
+        palette[3][0] = 0;
+        palette[3][1] = 0;
+        palette[3][2] = 0;
+        palette[3][3] = 0;
+    }
+    palette[0][3] = 255;
+    palette[1][3] = 255;
+    palette[2][3] = 255;
+}
+
+// Function to pick the nearest palette entry (squared RGB distance, lowest index on ties) for
+// each of 16 RGBA texels by comparing all four distances, and pack the 2-bit indices, texel 0
+// in the low bits. Reference for selectPaletteIndices.
+inline uint32_t selectPaletteIndicesExhaustive(const uint8_t* block, const uint8_t palette[4][4]) {
+    uint32_t packedIndices = 0;
+    for (int k = 0; k < 16; ++k) {
+        int r = block[k * 4];
+        int g = block[k * 4 + 1];
+        int b = block[k * 4 + 2];
+
+        uint32_t bestDistance = UINT32_MAX;
+        uint32_t bestIndex = 0;
+        for (uint32_t index = 0; index < 4; ++index) {
+            int dr = r - palette[index][0];
+            int dg = g - palette[index][1];
+            int db = b - palette[index][2];
+            uint32_t distance = dr * dr + dg * dg + db * db;
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                bestIndex = index;
+            }
+        }
+        packedIndices |= bestIndex << (2 * k);
+    }
+    return packedIndices;
 }
 
-#endif // COLOR_UTILS_H
\ No newline at end of file
+// Palette index of each position along the endpoint axis: color0, 1/3, 2/3, color1, two bits each
+const uint32_t AXIS_POSITION_INDICES = 0x78;
+
+// Function to pick palette indices for 16 RGBA texels of a 4-color palette, one byte per texel,
+// by projecting each texel onto the axis from entry 0 to entry 1. The projection finds the pair of neighbouring
+// entries the texel falls between, and the exact distances to those two decide, which absorbs
+// the rounding that moves the interpolated entries off the ideal thirds. There are no
+// data-dependent branches, so the loop compiles to selects and vectorizes across texels.
+// For endpoints at the corners of the texels' bounding box, as the encoders pick them, the
+// error matches selectPaletteIndicesExhaustive; ties may resolve to another index. The encoders
+// run the vector version in compression/dxt/dxt_kernels.inl, which must give the same indices.
+inline void selectPaletteIndexFields(const uint8_t* block, const uint8_t palette[4][4], uint8_t* indices) {
+    // Entries in axis order
+    int axis[4][3];
+    for (int position = 0; position < 4; ++position) {
+        int index = (AXIS_POSITION_INDICES >> (2 * position)) & 0x03;
+        axis[position][0] = palette[index][0];
+        axis[position][1] = palette[index][1];
+        axis[position][2] = palette[index][2];
+    }
+    int dirR = axis[3][0] - axis[0][0];
+    int dirG = axis[3][1] - axis[0][1];
+    int dirB = axis[3][2] - axis[0][2];
+    // Projections of the interpolated entries, which rounding moves off the ideal thirds
+    int third = (axis[1][0] - axis[0][0]) * dirR + (axis[1][1] - axis[0][1]) * dirG + (axis[1][2] - axis[0][2]) * dirB;
+    int twoThirds = (axis[2][0] - axis[0][0]) * dirR + (axis[2][1] - axis[0][1]) * dirG + (axis[2][2] - axis[0][2]) * dirB;
+
+    // Whole texels, so the channel loads vectorize as shifts within one 32-bit lane
+    uint32_t texels[16];
+    std::memcpy(texels, block, sizeof(texels));
+#ifdef TCA_BIG_ENDIAN
+    const int shiftR = 24, shiftG = 16, shiftB = 8;
+#else
+    const int shiftR = 0, shiftG = 8, shiftB = 16;
+#endif
+
+    for (int k = 0; k < 16; ++k) {
+        int r = (texels[k] >> shiftR) & 0xFF;
+        int g = (texels[k] >> shiftG) & 0xFF;
+        int b = (texels[k] >> shiftB) & 0xFF;
+
+        // Segment between the interpolated entries the texel projects into
+        int projection = (r - axis[0][0]) * dirR + (g - axis[0][1]) * dirG + (b - axis[0][2]) * dirB;
+        int lower = (projection > third) + (projection > twoThirds);
+
+        int lowerR = lower == 0 ? axis[0][0] : lower == 1 ? axis[1][0] : axis[2][0];
+        int lowerG = lower == 0 ? axis[0][1] : lower == 1 ? axis[1][1] : axis[2][1];
+        int lowerB = lower == 0 ? axis[0][2] : lower == 1 ? axis[1][2] : axis[2][2];
+        int upperR = lower == 0 ? axis[1][0] : lower == 1 ? axis[2][0] : axis[3][0];
+        int upperG = lower == 0 ? axis[1][1] : lower == 1 ? axis[2][1] : axis[3][1];
+        int upperB = lower == 0 ? axis[1][2] : lower == 1 ? axis[2][2] : axis[3][2];
+
+        int lowerDistance = (r - lowerR) * (r - lowerR) + (g - lowerG) * (g - lowerG) + (b - lowerB) * (b - lowerB);
+        int upperDistance = (r - upperR) * (r - upperR) + (g - upperG) * (g - upperG) + (b - upperB) * (b - upperB);
+        int position = lower + (upperDistance < lowerDistance);
+        indices[k] = static_cast<uint8_t>((AXIS_POSITION_INDICES >> (2 * position)) & 0x03);
+    }
+}
+
+// Function to pick palette indices as selectPaletteIndexFields does and pack them, texel 0 in
+// the low bits
+inline uint32_t selectPaletteIndices(const uint8_t* block, const uint8_t palette[4][4]) {
+    uint8_t indices[16];
+    selectPaletteIndexFields(block, palette, indices);
+    return static_cast<uint32_t>(packIndexFields<2>(indices));
+}
+
+} // namespace TCA_ISA_NAMESPACE
+
+#endif // COLOR_UTILS_H
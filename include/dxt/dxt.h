@@ -0,0 +1,45 @@
+#ifndef DXT_H
+#define DXT_H
+
+#include <cstdint>
+#include <vector>
+#include "../image/image_buffer.h"
+
+// Size of one compressed 4x4 block in bytes
+const int DXT1_BLOCK_BYTES = 8;
+const int DXT2_BLOCK_BYTES = 16;
+
+// Block kernels. A block is 16 RGBA texels (64 bytes) in row-major order. These and the
+// row-range drivers run the kernels of the active instruction set (see dxt_kernels.h).
+void compressBlockDXT1(const uint8_t* block, uint8_t* output);
+void decompressBlockDXT1(const uint8_t* input, uint8_t* block);
+void compressBlockDXT2(const uint8_t* block, uint8_t* output);
+void compressOpaqueBlockDXT2(const uint8_t* block, uint8_t* output); // Ignores alpha; for inputs without an alpha channel
+void decompressBlockDXT2(const uint8_t* input, uint8_t* block);
+
+// Row-range drivers. Block rows [firstBlockRow, lastBlockRow) are read from / written to
+// their final position in the full-image buffers, so disjoint ranges can run in parallel.
+// The encoders read the image in its own layout (1 to 4 channels; see ImageView).
+void compressBlockRowsDXT1(const ImageView& image, int firstBlockRow, int lastBlockRow, uint8_t* compressedData);
+void decompressBlockRowsDXT1(const uint8_t* compressedData, int width, int height, int firstBlockRow, int lastBlockRow, uint8_t* textureData);
+void compressBlockRowsDXT2(const ImageView& image, int firstBlockRow, int lastBlockRow, uint8_t* compressedData);
+void decompressBlockRowsDXT2(const uint8_t* compressedData, int width, int height, int firstBlockRow, int lastBlockRow, uint8_t* textureData);
+
+// Dirty-rectangle updates. Re-encode only the blocks overlapping the rectangle into an
+// existing compressed image of the same dimensions; textureData is the full updated image.
+// Returns false if compressedData does not match the dimensions.
+bool recompressRegionDXT1(const ImageView& image, int regionX, int regionY, int regionWidth, int regionHeight, std::vector<uint8_t>& compressedData);
+bool recompressRegionDXT2(const ImageView& image, int regionX, int regionY, int regionWidth, int regionHeight, std::vector<uint8_t>& compressedData);
+
+// Whole-image entry points
+void compressWithDXT1(const ImageView& image, std::vector<uint8_t>& compressedData);
+void decompressWithDXT1(const std::vector<uint8_t>& compressedData, int width, int height, std::vector<uint8_t>& textureData);
+void compressWithDXT2(const ImageView& image, std::vector<uint8_t>& compressedData);
+void decompressWithDXT2(const std::vector<uint8_t>& compressedData, int width, int height, std::vector<uint8_t>& textureData);
+
+// Decoding into caller memory of width * height * 4 bytes, which is fully overwritten and so
+// needs no zero-fill (e.g. a pooled buffer). Returns false if compressedData is too small.
+bool decompressWithDXT1(const uint8_t* compressedData, size_t compressedBytes, int width, int height, uint8_t* textureData);
+bool decompressWithDXT2(const uint8_t* compressedData, size_t compressedBytes, int width, int height, uint8_t* textureData);
+
+#endif // DXT_H
@@ -0,0 +1,89 @@
+#ifndef DXT_BLOCK_H
+#define DXT_BLOCK_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "../simd/simd.h"
+
+// Typed compressed blocks. Kernels build a block in registers and write it with one load or
+// store instead of assembling it byte by byte. On disk and in every buffer the fields are
+// little-endian; loadBC*Block/storeBC*Block convert on big-endian hosts and are a plain memcpy
+// (a single 8- or 16-byte move) everywhere else. Going through memcpy keeps them valid for
+// any alignment, since block data also starts at container header offsets such as 148 bytes.
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define TCA_BIG_ENDIAN 1
+#endif
+
+// DXT1 / BC1 block, also the color half of DXT2
+struct alignas(8) BC1Block {
+    uint16_t color0;  // First endpoint, RGB565
+    uint16_t color1;  // Second endpoint, RGB565
+    uint32_t indices; // 2-bit palette index per texel, texel 0 in the low bits
+};
+
+// DXT2 / BC2 block: explicit alpha followed by a color block
+struct alignas(16) BC2Block {
+    uint64_t alpha; // 4-bit alpha per texel, texel 0 in the low nibble
+    BC1Block color;
+};
+
+static_assert(sizeof(BC1Block) == 8 && std::is_trivially_copyable<BC1Block>::value, "BC1Block must match the 8-byte block layout");
+static_assert(sizeof(BC2Block) == 16 && std::is_trivially_copyable<BC2Block>::value, "BC2Block must match the 16-byte block layout");
+
+inline namespace TCA_ISA_NAMESPACE {
+
+#ifdef TCA_BIG_ENDIAN
+// Helper function to byte-swap the fields of a block between host and little-endian order
+inline void swapBlockFields(BC1Block& block) {
+    block.color0 = __builtin_bswap16(block.color0);
+    block.color1 = __builtin_bswap16(block.color1);
+    block.indices = __builtin_bswap32(block.indices);
+}
+
+inline void swapBlockFields(BC2Block& block) {
+    block.alpha = __builtin_bswap64(block.alpha);
+    swapBlockFields(block.color);
+}
+#endif
+
+// Function to read a block from 8 bytes of compressed data
+inline BC1Block loadBC1Block(const uint8_t* input) {
+    BC1Block block;
+    std::memcpy(&block, input, sizeof(block));
+#ifdef TCA_BIG_ENDIAN
+    swapBlockFields(block);
+#endif
+    return block;
+}
+
+// Function to write a block to 8 bytes of compressed data
+inline void storeBC1Block(BC1Block block, uint8_t* output) {
+#ifdef TCA_BIG_ENDIAN
+    swapBlockFields(block);
+#endif
+    std::memcpy(output, &block, sizeof(block));
+}
+
+// Function to read a block from 16 bytes of compressed data
+inline BC2Block loadBC2Block(const uint8_t* input) {
+    BC2Block block;
+    std::memcpy(&block, input, sizeof(block));
+#ifdef TCA_BIG_ENDIAN
+    swapBlockFields(block);
+#endif
+    return block;
+}
+
+// Function to write a block to 16 bytes of compressed data
+inline void storeBC2Block(BC2Block block, uint8_t* output) {
+#ifdef TCA_BIG_ENDIAN
+    swapBlockFields(block);
+#endif
+    std::memcpy(output, &block, sizeof(block));
+}
+
+} // namespace TCA_ISA_NAMESPACE
+
+#endif // DXT_BLOCK_H
@@ -0,0 +1,46 @@
+#ifndef DXT_KERNELS_H
+#define DXT_KERNELS_H
+
+#include <cstdint>
+#include "../image/image_buffer.h"
+#include "../simd/dispatch.h"
+
+// The DXT kernels of one instruction set. compression/dxt/dxt_kernels.inl holds their source,
+// compiled once per SimdIsa by the dxt_kernels_<isa>.cpp translation units; the entry points
+// in dxt.h call through the table of the active instruction set. Every table produces the same
+// bits as the Generic one.
+struct DXTKernels {
+    SimdIsa isa;
+    bool bmi2Packing; // Index fields packed with pext/pdep rather than shift-and-mask merges
+
+    void (*compressBlockDXT1)(const uint8_t* block, uint8_t* output);
+    void (*decompressBlockDXT1)(const uint8_t* input, uint8_t* block);
+    void (*compressBlockRowsDXT1)(const ImageView& image, int firstBlockRow, int lastBlockRow, uint8_t* compressedData);
+    void (*decompressBlockRowsDXT1)(const uint8_t* compressedData, int width, int height, int firstBlockRow, int lastBlockRow, uint8_t* textureData);
+
+    void (*compressBlockDXT2)(const uint8_t* block, uint8_t* output);
+    void (*compressOpaqueBlockDXT2)(const uint8_t* block, uint8_t* output);
+    void (*decompressBlockDXT2)(const uint8_t* input, uint8_t* block);
+    void (*compressBlockRowsDXT2)(const ImageView& image, int firstBlockRow, int lastBlockRow, uint8_t* compressedData);
+    void (*decompressBlockRowsDXT2)(const uint8_t* compressedData, int width, int height, int firstBlockRow, int lastBlockRow, uint8_t* textureData);
+
+    // Palette index selection of both encoders, packed with texel 0 in the low bits (see
+    // selectPaletteIndices in color_utils.h, which it matches)
+    uint32_t (*selectPaletteIndices)(const uint8_t* block, const uint8_t palette[4][4]);
+};
+
+// Per-instruction-set tables, defined by the dxt_kernels_<isa>.cpp translation units. Only
+// the Scalar and Generic ones are always built.
+const DXTKernels& getDXTKernelsScalar();
+const DXTKernels& getDXTKernelsGeneric();
+const DXTKernels& getDXTKernelsAVX2();
+const DXTKernels& getDXTKernelsAVX512();
+
+// Function to get the table of an instruction set, or nullptr if this build has none for it
+// or the CPU cannot run it
+const DXTKernels* getDXTKernels(SimdIsa isa);
+
+// Function to get the table of the active instruction set (see getActiveSimdIsa)
+const DXTKernels& getDXTKernels();
+
+#endif // DXT_KERNELS_H
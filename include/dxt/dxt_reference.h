@@ -0,0 +1,27 @@
+#ifndef DXT_REFERENCE_H
+#define DXT_REFERENCE_H
+
+#include <cstdint>
+#include "../compression/compression_algorithm.h"
+#include "../image/image_buffer.h"
+
+// Reference DXT1 and DXT2 codecs, written apart from the kernels in compression/dxt/dxt_kernels.inl
+// so a logic error there cannot hide in both. Texels are read one at a time, palettes are built
+// entry by entry from the decoder profile's tables, indices come from selectPaletteIndexFields in
+// color_utils.h, and blocks are assembled byte by byte. They are slow; TextureBenchmark --verify
+// uses them as the ground truth every kernel table must reproduce bit for bit.
+
+// Function to encode 16 RGBA texels into one DXT1 or DXT2 block
+void compressBlockReference(CompressionAlgorithm algorithm, const uint8_t* block, uint8_t* output);
+
+// Function to decode one DXT1 or DXT2 block into 16 RGBA texels
+void decompressBlockReference(CompressionAlgorithm algorithm, const uint8_t* input, uint8_t* block);
+
+// Function to encode a whole image; compressedData gets every block in row order. Texels beyond
+// the image's edges are encoded as opaque black, as the kernels pad edge blocks.
+void compressImageReference(CompressionAlgorithm algorithm, const ImageView& image, uint8_t* compressedData);
+
+// Function to decode a whole image into width * height RGBA texels
+void decompressImageReference(CompressionAlgorithm algorithm, const uint8_t* compressedData, int width, int height, uint8_t* textureData);
+
+#endif // DXT_REFERENCE_H
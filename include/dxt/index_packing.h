@@ -0,0 +1,117 @@
+#ifndef INDEX_PACKING_H
+#define INDEX_PACKING_H
+
+#include <cstdint>
+#include <cstring>
+#include "dxt_block.h"
+#include "../simd/cpu_features.h"
+#include "../simd/simd.h"
+
+#ifdef TCA_X86
+#include <immintrin.h>
+#endif
+
+// Packing of the per-texel fields of a block (2-bit color indices, 4-bit explicit alpha, and
+// 3-bit indices for the interpolated alpha formats) between 16 bytes, one value per texel, and
+// the block's bit field, texel 0 in the low bits. The portable versions move whole 64-bit words
+// with shift/mask merges; the BMI2 versions are one pext or pdep per 8 texels.
+
+inline namespace TCA_ISA_NAMESPACE {
+
+// Helper function to get the mask selecting the low Bits bits of every byte
+template <int Bits>
+constexpr uint64_t byteFieldMask() {
+    return 0x0101010101010101ull * ((1u << Bits) - 1);
+}
+
+// Helper function to load 8 bytes as a little-endian word
+inline uint64_t loadBytesLE(const uint8_t* bytes) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+#ifdef TCA_BIG_ENDIAN
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+// Helper function to store a word as 8 little-endian bytes
+inline void storeBytesLE(uint64_t word, uint8_t* bytes) {
+#ifdef TCA_BIG_ENDIAN
+    word = __builtin_bswap64(word);
+#endif
+    std::memcpy(bytes, &word, sizeof(word));
+}
+
+// Helper function to gather the low Bits bits of 8 bytes into 8 * Bits contiguous bits
+template <int Bits>
+inline uint64_t compactByteFields(uint64_t word) {
+    static_assert(Bits >= 1 && Bits <= 4, "Fields wider than 4 bits do not fit the merge steps");
+    word &= byteFieldMask<Bits>();
+    word = (word | (word >> (8 - Bits))) & (0x0001000100010001ull * ((1u << (2 * Bits)) - 1));
+    word = (word | (word >> (16 - 2 * Bits))) & (0x0000000100000001ull * ((1ull << (4 * Bits)) - 1));
+    return (word | (word >> (32 - 4 * Bits))) & ((1ull << (8 * Bits)) - 1);
+}
+
+// Helper function to spread 8 * Bits contiguous bits into the low Bits bits of 8 bytes
+template <int Bits>
+inline uint64_t spreadByteFields(uint64_t bits) {
+    static_assert(Bits >= 1 && Bits <= 4, "Fields wider than 4 bits do not fit the merge steps");
+    bits &= (1ull << (8 * Bits)) - 1;
+    bits = (bits | (bits << (32 - 4 * Bits))) & (0x0000000100000001ull * ((1ull << (4 * Bits)) - 1));
+    bits = (bits | (bits << (16 - 2 * Bits))) & (0x0001000100010001ull * ((1u << (2 * Bits)) - 1));
+    return (bits | (bits << (8 - Bits))) & byteFieldMask<Bits>();
+}
+
+// Function to pack 16 Bits-bit values, one per byte, into 16 * Bits bits
+template <int Bits>
+inline uint64_t packIndexFields(const uint8_t* values) {
+    return compactByteFields<Bits>(loadBytesLE(values)) | (compactByteFields<Bits>(loadBytesLE(values + 8)) << (8 * Bits));
+}
+
+// Function to unpack 16 * Bits bits into 16 values, one per byte
+template <int Bits>
+inline void unpackIndexFields(uint64_t packed, uint8_t* values) {
+    storeBytesLE(spreadByteFields<Bits>(packed), values);
+    storeBytesLE(spreadByteFields<Bits>(packed >> (8 * Bits)), values + 8);
+}
+
+#ifdef TCA_X86
+// BMI2 versions; only call them from code selected when getCpuFeatures().fastPdep is set
+template <int Bits>
+TCA_TARGET("bmi2") inline uint64_t packIndexFieldsBMI2(const uint8_t* values) {
+    return _pext_u64(loadBytesLE(values), byteFieldMask<Bits>()) | (_pext_u64(loadBytesLE(values + 8), byteFieldMask<Bits>()) << (8 * Bits));
+}
+
+template <int Bits>
+TCA_TARGET("bmi2") inline void unpackIndexFieldsBMI2(uint64_t packed, uint8_t* values) {
+    storeBytesLE(_pdep_u64(packed, byteFieldMask<Bits>()), values);
+    storeBytesLE(_pdep_u64(packed >> (8 * Bits), byteFieldMask<Bits>()), values + 8);
+}
+#endif
+
+// Helper functions choosing the implementation at compile time, for kernels instantiated once
+// per instruction set
+template <int Bits, bool UseBMI2>
+inline uint64_t packIndexFieldsWith(const uint8_t* values) {
+#ifdef TCA_X86
+    if constexpr (UseBMI2) {
+        return packIndexFieldsBMI2<Bits>(values);
+    }
+#endif
+    return packIndexFields<Bits>(values);
+}
+
+template <int Bits, bool UseBMI2>
+inline void unpackIndexFieldsWith(uint64_t packed, uint8_t* values) {
+#ifdef TCA_X86
+    if constexpr (UseBMI2) {
+        unpackIndexFieldsBMI2<Bits>(packed, values);
+        return;
+    }
+#endif
+    unpackIndexFields<Bits>(packed, values);
+}
+
+} // namespace TCA_ISA_NAMESPACE
+
+#endif // INDEX_PACKING_H
@@ -0,0 +1,8 @@
+#ifndef ENCODER_VERSION_H
+#define ENCODER_VERSION_H
+
+// Version of the block encoders. Bump whenever a codec change alters the
+// compressed output so reports and caches can tell encoder generations apart.
+#define TCA_ENCODER_VERSION "1.3.0"
+
+#endif // ENCODER_VERSION_H
@@ -0,0 +1,46 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "page_allocator.h"
+
+// Allocation counters of a pool
+struct BufferPoolStats {
+    uint64_t requests = 0;      // acquire() calls
+    uint64_t allocations = 0;   // Requests that had to grow a buffer
+    uint64_t bytesReserved = 0; // Capacity currently held across all buffers
+    uint64_t hugePageBytes = 0; // Part of bytesReserved backed by huge pages
+};
+
+// Scratch memory for one worker of a batch loop. Each slot holds one buffer that keeps its
+// capacity across algorithms and files, so once the largest image has been seen the loop stops
+// allocating and touching fresh pages. Buffers are handed out uninitialized; callers write them
+// in full (see the decode functions taking a uint8_t* destination). A pool is not thread-safe:
+// every worker owns its own. Buffers of 2 MiB and more are backed by huge pages when the pool is
+// created with a HugePageMode other than Off.
+class BufferPool {
+public:
+    explicit BufferPool(HugePageMode hugePages = HugePageMode::Off) : hugePages_(hugePages) {}
+
+    // Function to get slot's buffer with room for at least bytes bytes. The contents are
+    // unspecified, and the pointer stays valid until the slot is acquired again with a larger size.
+    uint8_t* acquire(size_t slot, size_t bytes);
+
+    // Function to release every buffer
+    void clear();
+
+    const BufferPoolStats& stats() const { return stats_; }
+
+private:
+    static bool isHugePageBacked(const PageBuffer& buffer) {
+        return buffer.backing() == PageBacking::Transparent || buffer.backing() == PageBacking::Explicit;
+    }
+
+    HugePageMode hugePages_;
+    std::vector<PageBuffer> buffers_;
+    BufferPoolStats stats_;
+};
+
+#endif // BUFFER_POOL_H
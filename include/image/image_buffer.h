@@ -0,0 +1,119 @@
+#ifndef IMAGE_BUFFER_H
+#define IMAGE_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../simd/simd.h"
+
+// Read-only view of 8-bit texels. Rows are stride bytes apart, so a view can describe a whole
+// image, a sub-rectangle of one, or rows with padding, wherever the memory came from (an stb
+// allocation, a memory mapping, caller memory). The view does not own the texels.
+//
+// Texels keep the layout of the source, as stb_image reports it: 1 channel is grey, 2 is grey
+// and alpha, 3 is RGB and 4 is RGBA. Grey expands to equal R, G and B, and inputs without an
+// alpha channel are opaque.
+struct ImageView {
+    const uint8_t* data = nullptr;
+    int width = 0;
+    int height = 0;
+    size_t stride = 0; // Bytes from one row to the next
+    int channels = 4;
+
+    ImageView() = default;
+    ImageView(const uint8_t* data, int width, int height, size_t stride, int channels = 4)
+        : data(data), width(width), height(height), stride(stride), channels(channels) {}
+
+    // Tightly packed texels held in a vector
+    ImageView(const std::vector<uint8_t>& texels, int width, int height, int channels = 4)
+        : data(texels.data()), width(width), height(height), stride(static_cast<size_t>(width) * channels), channels(channels) {}
+
+    const uint8_t* row(int y) const { return data + static_cast<size_t>(y) * stride; }
+    const uint8_t* texel(int x, int y) const { return row(y) + static_cast<size_t>(x) * channels; }
+    size_t rowBytes() const { return static_cast<size_t>(width) * channels; }
+    bool empty() const { return data == nullptr || width <= 0 || height <= 0; }
+    bool isPacked() const { return stride == rowBytes(); }
+    bool hasAlpha() const { return channels == 2 || channels == 4; }
+
+    // Function to get the view of a rectangle, which must lie inside this view
+    ImageView subView(int x, int y, int subWidth, int subHeight) const { return ImageView(texel(x, y), subWidth, subHeight, stride, channels); }
+};
+
+inline namespace TCA_ISA_NAMESPACE {
+
+// Function to expand one texel of a Channels-channel layout to RGBA
+template <int Channels>
+inline void expandTexel(const uint8_t* source, uint8_t* rgba) {
+    static_assert(Channels >= 1 && Channels <= 4, "1 to 4 channels");
+    if (Channels <= 2) {
+        rgba[0] = rgba[1] = rgba[2] = source[0];
+    } else {
+        rgba[0] = source[0];
+        rgba[1] = source[1];
+        rgba[2] = source[2];
+    }
+    rgba[3] = Channels == 2 ? source[1] : Channels == 4 ? source[3] : 255;
+}
+
+// Function to expand count texels of a Channels-channel row to RGBA
+template <int Channels>
+inline void expandTexels(const uint8_t* source, int count, uint8_t* rgba) {
+    for (int i = 0; i < count; ++i) {
+        expandTexel<Channels>(source + i * Channels, rgba + i * 4);
+    }
+}
+
+// Function to expand one row of a view to RGBA; width * 4 bytes are written
+inline void expandRow(const ImageView& image, int y, uint8_t* rgba) {
+    const uint8_t* source = image.data + static_cast<size_t>(y) * image.stride;
+    switch (image.channels) {
+        case 1: expandTexels<1>(source, image.width, rgba); break;
+        case 2: expandTexels<2>(source, image.width, rgba); break;
+        case 3: expandTexels<3>(source, image.width, rgba); break;
+        default: expandTexels<4>(source, image.width, rgba); break;
+    }
+}
+
+} // namespace TCA_ISA_NAMESPACE
+
+// Owning 8-bit image with 1 to 4 channels (see ImageView). The texels are released by the
+// deleter the buffer was adopted with, so an allocation from a loader (stbi_load /
+// stbi_image_free) is used in place instead of being copied.
+class ImageBuffer {
+public:
+    typedef void (*Deleter)(void* texels);
+
+    ImageBuffer() = default;
+    ~ImageBuffer();
+    ImageBuffer(ImageBuffer&& other) noexcept;
+    ImageBuffer& operator=(ImageBuffer&& other) noexcept;
+    ImageBuffer(const ImageBuffer&) = delete;
+    ImageBuffer& operator=(const ImageBuffer&) = delete;
+
+    // Function to take ownership of texels that deleter releases
+    static ImageBuffer adopt(uint8_t* texels, int width, int height, size_t stride, int channels, Deleter deleter);
+
+    // Function to take ownership of tightly packed texels held in a vector
+    static ImageBuffer adopt(std::vector<uint8_t>&& texels, int width, int height, int channels = 4);
+
+    ImageView view() const { return ImageView(data_, width_, height_, stride_, channels_); }
+    const uint8_t* data() const { return data_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    size_t stride() const { return stride_; }
+    int channels() const { return channels_; }
+    bool empty() const { return data_ == nullptr; }
+
+    void reset();
+
+private:
+    uint8_t* data_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+    size_t stride_ = 0;
+    int channels_ = 4;
+    Deleter deleter_ = nullptr;
+    std::vector<uint8_t> storage_; // Owner of the texels when adopted from a vector
+};
+
+#endif // IMAGE_BUFFER_H
@@ -0,0 +1,46 @@
+#ifndef MIPMAP_H
+#define MIPMAP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../compression/block_codec.h"
+#include "../compression/block_dedupe_cache.h"
+#include "image_buffer.h"
+
+// Downsampling filters of the mip chain
+enum class MipFilter {
+    Box,     // 2x2 average; cheapest, softest
+    Kaiser,  // Kaiser-windowed sinc, radius 3; sharp with little ringing
+    Lanczos  // Lanczos-3 windowed sinc; sharpest, may ring on hard edges
+};
+
+// Function to get the short name of a filter (as accepted by parseMipFilter)
+std::string getMipFilterName(MipFilter filter);
+
+// Function to parse a filter name, returning false if it is unknown
+bool parseMipFilter(const std::string& name, MipFilter& filter);
+
+// Function to count the levels of a full chain down to 1x1
+int getMipLevelCount(int width, int height);
+
+// Function to halve an image (each dimension rounded down, at least 1), keeping its channel
+// layout. Color is filtered in linear light, treating the texels as sRGB; alpha is filtered as
+// stored.
+// threadCount 0 selects the hardware concurrency.
+std::vector<uint8_t> downsampleImage(const ImageView& image, MipFilter filter, int& outputWidth, int& outputHeight, int threadCount = 0);
+
+// One compressed level of a chain
+struct CompressedMipLevel {
+    int width;
+    int height;
+    std::vector<uint8_t> compressedData;
+};
+
+// Function to generate and compress the whole chain, base level first. Level N is encoded on a
+// separate thread while level N+1 is downsampled from the uncompressed level N; the two share
+// threadCount threads (0 selects the hardware concurrency). Levels go through dedupeCache when
+// one is given.
+std::vector<CompressedMipLevel> compressMipChain(const BlockCodec& codec, const ImageView& image, MipFilter filter, int threadCount = 0, BlockDedupeCache* dedupeCache = nullptr);
+
+#endif // MIPMAP_H
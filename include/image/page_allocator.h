@@ -0,0 +1,63 @@
+#ifndef PAGE_ALLOCATOR_H
+#define PAGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Page-level allocation for large pixel and block buffers. A linear scan over hundreds of MB
+// touches a new 4 KiB page every 4 KiB, so with regular pages the TLB misses on almost every
+// page; 2 MiB pages cut that 512-fold.
+
+const size_t HUGE_PAGE_BYTES = 2u << 20;
+
+// What to ask the kernel for
+enum class HugePageMode {
+    Off,         // Regular heap memory
+    Transparent, // 2 MiB-aligned anonymous mapping with madvise(MADV_HUGEPAGE)
+    Explicit     // MAP_HUGETLB from the reserved huge page pool, falling back to Transparent
+};
+
+// What a buffer actually got
+enum class PageBacking {
+    Heap,        // operator new; small requests, Off, or platforms without mmap
+    Regular,     // Anonymous mapping without huge pages (madvise unsupported or refused)
+    Transparent, // Anonymous mapping advised to use transparent huge pages
+    Explicit     // Mapping from the hugetlb pool
+};
+
+// Function to get the command line name of a mode (as accepted by parseHugePageMode)
+std::string getHugePageModeName(HugePageMode mode);
+
+// Function to parse a mode name, returning false if it is unknown
+bool parseHugePageMode(const std::string& name, HugePageMode& mode);
+
+// Function to get a readable name of a backing
+std::string getPageBackingName(PageBacking backing);
+
+// Owning, uninitialized buffer allocated according to a HugePageMode. Requests smaller than a
+// huge page always come from the heap. Every fallback is silent; backing() reports the outcome.
+class PageBuffer {
+public:
+    PageBuffer() = default;
+    PageBuffer(size_t bytes, HugePageMode mode);
+    ~PageBuffer();
+    PageBuffer(PageBuffer&& other) noexcept;
+    PageBuffer& operator=(PageBuffer&& other) noexcept;
+    PageBuffer(const PageBuffer&) = delete;
+    PageBuffer& operator=(const PageBuffer&) = delete;
+
+    uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    PageBacking backing() const { return backing_; }
+
+    void reset();
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t mappedBytes_ = 0; // Length of the mapping for mapped backings
+    PageBacking backing_ = PageBacking::Heap;
+};
+
+#endif // PAGE_ALLOCATOR_H
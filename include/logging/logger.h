@@ -0,0 +1,93 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+// Leveled, asynchronous logging.
+//
+// Call sites format their message only when the level is enabled, then hand it
+// to a bounded lock-free queue drained by a background thread; the hot path
+// never flushes. If the queue is full, Trace and Debug messages are dropped and
+// counted (and the count reported by the next logFlush); Info and above wait for
+// a free slot, so statistics and errors are never lost. Trace/Debug/Info go to
+// stdout, Warning/Error to stderr.
+
+enum class LogLevel { Trace, Debug, Info, Warning, Error, Off };
+
+// Current threshold; codecs log at Debug, so they are silent at the default Info level
+extern std::atomic<int> gLogLevel;
+
+inline bool logEnabled(LogLevel level) {
+    return static_cast<int>(level) >= gLogLevel.load(std::memory_order_relaxed);
+}
+
+void setLogLevel(LogLevel level);
+
+// Function to parse "trace", "debug", "info", "warning", "error" or "off"
+bool parseLogLevel(const std::string& name, LogLevel& level);
+
+// Function to enqueue a formatted message without waiting for it to be written
+void logMessage(LogLevel level, const std::string& message);
+
+// Function to block until every message enqueued so far has been written, then
+// report on stderr how many Trace/Debug messages were dropped since the last flush
+void logFlush();
+
+// Number of Trace/Debug messages dropped because the queue was full
+uint64_t logDroppedMessages();
+
+// Allows at most `burst` messages per window; the rest are counted and reported
+// with the next message that gets through
+class LogRateLimiter {
+public:
+    LogRateLimiter(int burst, double windowSeconds);
+
+    // Returns true if a message may be logged now; suppressed receives the
+    // number of messages swallowed since the last one that was allowed
+    bool allow(uint64_t& suppressed);
+
+private:
+    const int burst_;
+    const uint64_t windowNanoseconds_;
+    std::atomic<uint64_t> windowStart_;
+    std::atomic<int> count_;
+    std::atomic<uint64_t> suppressed_;
+};
+
+#define TCA_LOG(level, expr)                                   \
+    do {                                                       \
+        if (logEnabled(level)) {                               \
+            std::ostringstream tcaLogStream_;                  \
+            tcaLogStream_ << expr;                             \
+            logMessage(level, tcaLogStream_.str());            \
+        }                                                      \
+    } while (0)
+
+#define LOG_TRACE(expr) TCA_LOG(LogLevel::Trace, expr)
+#define LOG_DEBUG(expr) TCA_LOG(LogLevel::Debug, expr)
+#define LOG_INFO(expr) TCA_LOG(LogLevel::Info, expr)
+#define LOG_WARNING(expr) TCA_LOG(LogLevel::Warning, expr)
+#define LOG_ERROR(expr) TCA_LOG(LogLevel::Error, expr)
+
+// Error logging for messages that can repeat per block or per texel: at most
+// five per second per call site, with a count of the ones that were swallowed
+#define LOG_ERROR_RATE_LIMITED(expr)                                               \
+    do {                                                                           \
+        if (logEnabled(LogLevel::Error)) {                                         \
+            static LogRateLimiter tcaLogLimiter_(5, 1.0);                          \
+            uint64_t tcaLogSuppressed_ = 0;                                        \
+            if (tcaLogLimiter_.allow(tcaLogSuppressed_)) {                         \
+                std::ostringstream tcaLogStream_;                                  \
+                tcaLogStream_ << expr;                                             \
+                if (tcaLogSuppressed_ > 0) {                                       \
+                    tcaLogStream_ << " (" << tcaLogSuppressed_ << " similar messages suppressed)"; \
+                }                                                                  \
+                logMessage(LogLevel::Error, tcaLogStream_.str());                  \
+            }                                                                      \
+        }                                                                          \
+    } while (0)
+
+#endif // LOGGER_H
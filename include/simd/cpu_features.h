@@ -0,0 +1,41 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// Instruction set extensions of the running CPU, detected once on first use. Kernels compiled
+// for an extension are only selected when the matching flag is set.
+struct CpuFeatures {
+    bool bmi2 = false;
+    bool fastPdep = false; // BMI2 with pdep/pext in hardware; AMD before Zen 3 microcodes them at ~250 cycles
+    bool avx2 = false;     // Also requires the OS to save the YMM registers
+    bool avx512 = false;   // AVX-512 F, BW and VL, with the OS saving the ZMM and mask registers
+};
+
+// Function to get the features of the running CPU
+const CpuFeatures& getCpuFeatures();
+
+// Per-function code generation for an extension. A function marked TCA_TARGET("bmi2") may use
+// the extension's intrinsics and inlines portable helpers into the extension's code; nothing
+// outside it is compiled for the extension, so the build keeps running on any x86-64. Adding
+// TCA_FLATTEN inlines the whole call tree, so helper templates get the extension too.
+// TCA_NOINLINE keeps a kernel a separate function where inlining it would hurt.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TCA_X86 1
+#define TCA_TARGET(extension) __attribute__((target(extension)))
+#define TCA_FLATTEN __attribute__((flatten))
+#define TCA_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define TCA_X86 1
+#define TCA_TARGET(extension)
+#define TCA_FLATTEN
+#define TCA_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__) || defined(__clang__)
+#define TCA_TARGET(extension)
+#define TCA_FLATTEN __attribute__((flatten))
+#define TCA_NOINLINE __attribute__((noinline))
+#else
+#define TCA_TARGET(extension)
+#define TCA_FLATTEN
+#define TCA_NOINLINE
+#endif
+
+#endif // CPU_FEATURES_H
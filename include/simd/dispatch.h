@@ -0,0 +1,47 @@
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+#include <string>
+
+// Instruction sets the kernels are compiled for, in increasing order. Each codec builds one
+// kernel table per instruction set in its own translation unit and the best one the CPU runs
+// is selected once, at first use.
+enum class SimdIsa {
+    Scalar,  // One texel at a time, portable index packing; never selected by itself
+    Generic, // Baseline flags of the build (SSE2 on x86-64), portable index packing
+    AVX2,    // AVX2, with BMI2 index packing where pdep/pext are fast
+    AVX512   // AVX-512 F/BW/VL, with BMI2 index packing where pdep/pext are fast
+};
+
+const int SIMD_ISA_COUNT = 4;
+
+// Function to get the name of an instruction set (as accepted by parseSimdIsa and TCA_FORCE_ISA)
+std::string getSimdIsaName(SimdIsa isa);
+
+// Function to parse an instruction set name, returning false if it is unknown
+bool parseSimdIsa(const std::string& name, SimdIsa& isa);
+
+// Function to check whether this build has kernels for an instruction set and the CPU runs them.
+// The vector width alone decides; AMD before Zen 3, which microcodes pdep/pext, gets the AVX2
+// kernels with the portable index packing (see DXTKernels::bmi2Packing).
+bool isSimdIsaSupported(SimdIsa isa);
+
+// Function to get the instruction set every dispatched kernel uses: the best supported one,
+// unless the TCA_FORCE_ISA environment variable names another supported one (for benchmarking).
+// An unknown or unsupported TCA_FORCE_ISA is reported once and ignored.
+SimdIsa getActiveSimdIsa();
+
+// Function to pick from per-instruction-set kernel tables, indexed by SimdIsa, the one for isa,
+// falling back to the next lower table where one is missing (nullptr). The Scalar and Generic
+// tables must exist.
+template <typename Table>
+const Table& selectSimdTable(const Table* const (&tables)[SIMD_ISA_COUNT], SimdIsa isa) {
+    for (int level = static_cast<int>(isa); level > 0; --level) {
+        if (tables[level] != nullptr) {
+            return *tables[level];
+        }
+    }
+    return *tables[0];
+}
+
+#endif // SIMD_DISPATCH_H
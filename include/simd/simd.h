@@ -0,0 +1,157 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstdint>
+#include <cstring>
+
+// Fixed-width integer vectors for kernels written once and compiled per instruction set. The
+// register width follows the flags of the translation unit: 16 bytes for the generic build
+// (SSE2 on x86-64), 32 with AVX2, 64 with AVX-512. GCC and Clang map the operators onto native
+// vector instructions; other compilers get lane loops. Defining TCA_SIMD_SCALAR before the
+// include gives one-lane vectors on plain integers, for the scalar kernels.
+//
+// Everything is declared inside TCA_SIMD_NAMESPACE, which differs per instruction set. Inline
+// code compiled with different flags must not share a symbol: the linker keeps one copy, and
+// an AVX-512 copy reached from the generic kernels would fault on older CPUs.
+//
+// The inline helpers of the shared headers the kernels use (image_buffer.h, block_io.h,
+// color_utils.h, dxt_block.h, index_packing.h) are defined inside TCA_ISA_NAMESPACE for the
+// same reason. It is an inline namespace, so callers name them without qualification. Those
+// helpers must not call member functions or std:: templates, whose copies would still be shared.
+#if defined(TCA_SIMD_SCALAR)
+#define TCA_SIMD_BYTES 4
+#define TCA_SIMD_NAMESPACE simd_scalar
+#define TCA_ISA_NAMESPACE isa_scalar
+#elif defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+#define TCA_SIMD_BYTES 64
+#define TCA_SIMD_NAMESPACE simd_avx512
+#define TCA_ISA_NAMESPACE isa_avx512
+#elif defined(__AVX2__)
+#define TCA_SIMD_BYTES 32
+#define TCA_SIMD_NAMESPACE simd_avx2
+#define TCA_ISA_NAMESPACE isa_avx2
+#else
+#define TCA_SIMD_BYTES 16
+#define TCA_SIMD_NAMESPACE simd_generic
+#define TCA_ISA_NAMESPACE isa_generic
+#endif
+
+// Whether the translation unit may use pdep/pext
+#if defined(__BMI2__) && !defined(TCA_SIMD_SCALAR)
+#define TCA_SIMD_BMI2 true
+#else
+#define TCA_SIMD_BMI2 false
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(TCA_SIMD_SCALAR)
+#define TCA_SIMD_NATIVE 1
+#endif
+
+namespace TCA_SIMD_NAMESPACE {
+
+// Lanes signed integers of type T. Comparisons return masks: all bits set in the lanes where
+// they hold, zero elsewhere, for use with select and the bitwise operators.
+template <typename T, int Lanes>
+struct Vec {
+    static const int LANES = Lanes;
+#ifdef TCA_SIMD_NATIVE
+    typedef T Native __attribute__((vector_size(sizeof(T) * Lanes)));
+#else
+    struct Native {
+        T lane[Lanes];
+        T& operator[](int i) { return lane[i]; }
+        T operator[](int i) const { return lane[i]; }
+    };
+#endif
+    Native value;
+
+    Vec() : value() {}
+
+    // Broadcast, so scalars mix with vectors in expressions
+    Vec(T scalar) {
+        for (int i = 0; i < Lanes; ++i) {
+            value[i] = scalar;
+        }
+    }
+
+    // Function to load Lanes values from unaligned memory
+    static Vec load(const void* source) {
+        Vec result;
+        std::memcpy(&result.value, source, sizeof(Native));
+        return result;
+    }
+
+    // Function to store Lanes values to unaligned memory
+    void store(void* destination) const {
+        std::memcpy(destination, &value, sizeof(Native));
+    }
+
+    T operator[](int i) const {
+        return value[i];
+    }
+
+#ifdef TCA_SIMD_NATIVE
+#define TCA_SIMD_BINARY(op, left, right) \
+    Vec result;                          \
+    result.value = (left) op (right);    \
+    return result
+#define TCA_SIMD_COMPARE(op, left, right)                       \
+    Vec result;                                                 \
+    result.value = reinterpret_cast<Native>((left) op (right)); \
+    return result
+#define TCA_SIMD_SHIFT(op, left, count) \
+    Vec result;                         \
+    result.value = (left) op (count);   \
+    return result
+#else
+#define TCA_SIMD_BINARY(op, left, right)                           \
+    Vec result;                                                    \
+    for (int i = 0; i < Lanes; ++i) {                              \
+        result.value[i] = static_cast<T>((left)[i] op (right)[i]); \
+    }                                                              \
+    return result
+#define TCA_SIMD_COMPARE(op, left, right)                         \
+    Vec result;                                                   \
+    for (int i = 0; i < Lanes; ++i) {                             \
+        result.value[i] = (left)[i] op (right)[i] ? T(-1) : T(0); \
+    }                                                             \
+    return result
+#define TCA_SIMD_SHIFT(op, left, count)                         \
+    Vec result;                                                 \
+    for (int i = 0; i < Lanes; ++i) {                           \
+        result.value[i] = static_cast<T>((left)[i] op (count)); \
+    }                                                           \
+    return result
+#endif
+
+    friend Vec operator+(Vec a, Vec b) { TCA_SIMD_BINARY(+, a.value, b.value); }
+    friend Vec operator-(Vec a, Vec b) { TCA_SIMD_BINARY(-, a.value, b.value); }
+    friend Vec operator*(Vec a, Vec b) { TCA_SIMD_BINARY(*, a.value, b.value); }
+    friend Vec operator&(Vec a, Vec b) { TCA_SIMD_BINARY(&, a.value, b.value); }
+    friend Vec operator|(Vec a, Vec b) { TCA_SIMD_BINARY(|, a.value, b.value); }
+    friend Vec operator^(Vec a, Vec b) { TCA_SIMD_BINARY(^, a.value, b.value); }
+    friend Vec operator==(Vec a, Vec b) { TCA_SIMD_COMPARE(==, a.value, b.value); }
+    friend Vec operator<(Vec a, Vec b) { TCA_SIMD_COMPARE(<, a.value, b.value); }
+    friend Vec operator>(Vec a, Vec b) { TCA_SIMD_COMPARE(>, a.value, b.value); }
+
+    // Shifts move every lane by the same count; right shifts are arithmetic
+    friend Vec operator<<(Vec a, int count) { TCA_SIMD_SHIFT(<<, a.value, count); }
+    friend Vec operator>>(Vec a, int count) { TCA_SIMD_SHIFT(>>, a.value, count); }
+
+#undef TCA_SIMD_BINARY
+#undef TCA_SIMD_COMPARE
+#undef TCA_SIMD_SHIFT
+};
+
+// Function to pick the lanes of a where mask is set and those of b elsewhere
+template <typename T, int Lanes>
+inline Vec<T, Lanes> select(Vec<T, Lanes> mask, Vec<T, Lanes> a, Vec<T, Lanes> b) {
+    return (mask & a) | ((mask ^ Vec<T, Lanes>(T(-1))) & b);
+}
+
+// 32-bit lanes filling one register of the translation unit's instruction set
+typedef Vec<int32_t, TCA_SIMD_BYTES / 4> VecI32;
+
+} // namespace TCA_SIMD_NAMESPACE
+
+#endif // SIMD_H
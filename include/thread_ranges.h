@@ -0,0 +1,60 @@
+#ifndef THREAD_RANGES_H
+#define THREAD_RANGES_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Work split across short-lived std::threads. The calling thread takes a share of the work
+// instead of waiting idle.
+
+// Function to resolve a thread count option: threadCount itself, or the hardware concurrency for 0
+// or less
+inline int resolveThreadCount(int threadCount) {
+    if (threadCount > 0) {
+        return threadCount;
+    }
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// Function to split rows 0..rows-1 into up to threadCount contiguous ranges and run
+// rangeFunction(firstRow, lastRow) on each, the first range on the calling thread
+template <typename RangeFunction>
+void forEachRowRange(int rows, int threadCount, RangeFunction rangeFunction) {
+    threadCount = std::max(1, std::min(threadCount, rows));
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount - 1);
+    for (int t = 1; t < threadCount; ++t) {
+        workers.emplace_back(rangeFunction, static_cast<int>(static_cast<long long>(rows) * t / threadCount),
+                             static_cast<int>(static_cast<long long>(rows) * (t + 1) / threadCount));
+    }
+    rangeFunction(0, static_cast<int>(static_cast<long long>(rows) / threadCount));
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Function to run function(index) for indices 0..count-1 on up to threadCount threads. Indices are
+// handed out one at a time, so items of very different cost still balance.
+template <typename Function>
+void parallelFor(int count, int threadCount, Function function) {
+    threadCount = std::max(1, std::min(threadCount, count));
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int index = next++; index < count; index = next++) {
+            function(index);
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount - 1);
+    for (int t = 1; t < threadCount; ++t) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+}
+
+#endif // THREAD_RANGES_H
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include "../include/logging/logger.h"
+
+std::atomic<int> gLogLevel{static_cast<int>(LogLevel::Info)};
+
+namespace {
+
+// Longest message kept per entry; longer messages are truncated
+const size_t kLogMessageBytes = 240;
+// Number of queued messages; must be a power of two
+const size_t kLogQueueCapacity = 4096;
+
+struct LogSlot {
+    std::atomic<size_t> sequence;
+    LogLevel level;
+    uint32_t length;
+    char text[kLogMessageBytes];
+};
+
+// Bounded multi-producer, single-consumer queue. Each slot carries a sequence
+// number that tells producers whether it is free and the consumer whether it is
+// filled, so neither side takes a lock.
+class LogQueue {
+public:
+    LogQueue() {
+        for (size_t i = 0; i < kLogQueueCapacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(LogLevel level, const std::string& message) {
+        size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+        LogSlot* slot;
+        for (;;) {
+            slot = &slots_[position & (kLogQueueCapacity - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false; // Full
+            } else {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->level = level;
+        slot->length = static_cast<uint32_t>(std::min(message.size(), kLogMessageBytes));
+        std::memcpy(slot->text, message.data(), slot->length);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side only
+    bool tryPop(LogLevel& level, char* text, uint32_t& length) {
+        LogSlot& slot = slots_[dequeuePosition_ & (kLogQueueCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition_ + 1) {
+            return false;
+        }
+        level = slot.level;
+        length = slot.length;
+        std::memcpy(text, slot.text, length);
+        slot.sequence.store(dequeuePosition_ + kLogQueueCapacity, std::memory_order_release);
+        ++dequeuePosition_;
+        return true;
+    }
+
+    size_t enqueued() const { return enqueuePosition_.load(std::memory_order_acquire); }
+
+private:
+    LogSlot slots_[kLogQueueCapacity];
+    std::atomic<size_t> enqueuePosition_{0};
+    size_t dequeuePosition_ = 0;
+};
+
+const char* levelPrefix(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "[trace] ";
+        case LogLevel::Debug: return "[debug] ";
+        case LogLevel::Warning: return "[warning] ";
+        case LogLevel::Error: return "[error] ";
+        default: return "";
+    }
+}
+
+// Owns the queue and the writer thread; torn down (after a final drain) at exit
+class AsyncLogger {
+public:
+    AsyncLogger() : writer_(&AsyncLogger::run, this) {}
+
+    ~AsyncLogger() {
+        stopping_.store(true, std::memory_order_release);
+        writer_.join();
+    }
+
+    // Trace and Debug messages are dropped when the queue is full; Info and above are the
+    // tool's console output, so they wait for the writer to free a slot instead
+    void push(LogLevel level, const std::string& message) {
+        while (!queue_.tryPush(level, message)) {
+            if (level < LogLevel::Info) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    void flush() {
+        size_t target = queue_.enqueued();
+        while (written_.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        uint64_t reported = reported_.exchange(dropped, std::memory_order_relaxed);
+        if (dropped > reported) {
+            std::fprintf(stderr, "%s%llu trace/debug messages dropped (log queue full)\n", levelPrefix(LogLevel::Warning),
+                         static_cast<unsigned long long>(dropped - reported));
+        }
+        std::fflush(stdout);
+        std::fflush(stderr);
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void run() {
+        LogLevel level;
+        char text[kLogMessageBytes];
+        uint32_t length;
+        for (;;) {
+            bool wrote = false;
+            while (queue_.tryPop(level, text, length)) {
+                FILE* stream = level >= LogLevel::Warning ? stderr : stdout;
+                std::fputs(levelPrefix(level), stream);
+                std::fwrite(text, 1, length, stream);
+                std::fputc('\n', stream);
+                written_.fetch_add(1, std::memory_order_release);
+                wrote = true;
+            }
+            if (wrote) {
+                std::fflush(stdout);
+                continue;
+            }
+            if (stopping_.load(std::memory_order_acquire) && written_.load() >= queue_.enqueued()) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::fflush(stdout);
+        std::fflush(stderr);
+    }
+
+    LogQueue queue_;
+    std::atomic<size_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> reported_{0}; // Drops already reported by flush
+    std::atomic<bool> stopping_{false};
+    std::thread writer_;
+};
+
+AsyncLogger& logger() {
+    static AsyncLogger instance;
+    return instance;
+}
+
+uint64_t steadyNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+void setLogLevel(LogLevel level) {
+    gLogLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+bool parseLogLevel(const std::string& name, LogLevel& level) {
+    static const struct { const char* name; LogLevel level; } levels[] = {
+        {"trace", LogLevel::Trace}, {"debug", LogLevel::Debug}, {"info", LogLevel::Info},
+        {"warning", LogLevel::Warning}, {"error", LogLevel::Error}, {"off", LogLevel::Off},
+    };
+    for (const auto& entry : levels) {
+        if (name == entry.name) {
+            level = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+void logMessage(LogLevel level, const std::string& message) {
+    logger().push(level, message);
+}
+
+void logFlush() {
+    logger().flush();
+}
+
+uint64_t logDroppedMessages() {
+    return logger().dropped();
+}
+
+LogRateLimiter::LogRateLimiter(int burst, double windowSeconds)
+    : burst_(burst),
+      windowNanoseconds_(static_cast<uint64_t>(windowSeconds * 1e9)),
+      windowStart_(steadyNanoseconds()),
+      count_(0),
+      suppressed_(0) {}
+
+bool LogRateLimiter::allow(uint64_t& suppressed) {
+    uint64_t now = steadyNanoseconds();
+    uint64_t windowStart = windowStart_.load(std::memory_order_relaxed);
+    if (now - windowStart >= windowNanoseconds_ &&
+        windowStart_.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+        count_.store(0, std::memory_order_relaxed);
+    }
+
+    if (count_.fetch_add(1, std::memory_order_relaxed) < burst_) {
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    suppressed = 0;
+    return false;
+}
@@ -3,6 +3,11 @@
 #include <vector>
 #include <filesystem>
 #include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <algorithm>
+#include <map>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "include/stb_image.h"
@@ -10,45 +15,266 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "include/stb_image_write.h"
 
-// Forward declaration of the DXT1 and DXT2 compression and decompression functions
-void compressWithDXT1(const std::vector<uint8_t>& textureData, int width, int height, std::vector<uint8_t>& compressedData);
-void decompressWithDXT1(const std::vector<uint8_t>& compressedData, int width, int height, std::vector<uint8_t>& textureData);
-void compressWithDXT2(const std::vector<uint8_t>& textureData, int width, int height, std::vector<uint8_t>& compressedData);
-void decompressWithDXT2(const std::vector<uint8_t>& compressedData, int width, int height, std::vector<uint8_t>& textureData);
-
-// Enum for different compression algorithms
-enum class CompressionAlgorithm {
-    DXT1, DXT2, DXT3, DXT4, DXT5,
-    ASTC_LDR, ASTC_HDR,
-    ETC1, ETC2,
-    PVRTC1, PVRTC2,
-    BC1, BC2, BC3, BC4, BC5, BC6H, BC7
+#include "include/analytics/perf_counters.h"
+#include "include/analytics/quality_metrics.h"
+#include "include/analytics/run_report.h"
+#include "include/analytics/trace.h"
+#include "include/cache/output_cache.h"
+#include "include/cache/run_manifest.h"
+#include "include/container/dds.h"
+#include "include/container/ktx2.h"
+#include "include/container/texture_archive.h"
+#include "include/encoder_version.h"
+#include "include/compression/block_codec.h"
+#include "include/compression/block_dedupe_cache.h"
+#include "include/compression/sequence_encoder.h"
+#include "include/compression/compression_algorithm.h"
+#include "include/corpus/synthetic_texture.h"
+#include "include/dxt/color_utils.h"
+#include "include/dxt/dxt.h"
+#include "include/dxt/dxt_kernels.h"
+#include "include/image/buffer_pool.h"
+#include "include/image/image_buffer.h"
+#include "include/image/mipmap.h"
+#include "include/logging/logger.h"
+#include "include/simd/dispatch.h"
+
+// File format of the compressed outputs
+enum class OutputContainer {
+    Raw,  // Bare block data (.compressed); dimensions and format are known out-of-band
+    DDS,  // DDS with the legacy FourCC header
+    DDS10, // DDS with the DX10 extension header
+    KTX2,  // KTX2
+    KTX2LZ // KTX2 with each mip level LZ-compressed (in-tree vendor scheme)
 };
 
-// Function to read PNG file and extract pixel data
-std::vector<uint8_t> readPNG(const std::string& filePath, int& width, int& height, int& channels) {
-    unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-    if (!data) {
-        std::cerr << "Failed to load PNG file: " << filePath << std::endl;
-        return {};
+// Function to get the command line name of a container
+std::string getContainerName(OutputContainer container) {
+    switch (container) {
+        case OutputContainer::Raw: return "raw";
+        case OutputContainer::DDS: return "dds";
+        case OutputContainer::DDS10: return "dds10";
+        case OutputContainer::KTX2: return "ktx2";
+        case OutputContainer::KTX2LZ: return "ktx2-lz";
     }
+    return "unknown";
+}
 
-    channels = 4; // Ensure we have 4 channels (RGBA)
-    std::vector<uint8_t> pixelData(data, data + (width * height * channels));
-    stbi_image_free(data);
-    return pixelData;
+// Function to get the file extension of a container
+std::string getContainerExtension(OutputContainer container) {
+    switch (container) {
+        case OutputContainer::DDS:
+        case OutputContainer::DDS10: return ".dds";
+        case OutputContainer::KTX2:
+        case OutputContainer::KTX2LZ: return ".ktx2";
+        default: return ".compressed";
+    }
+}
+
+// Buffer pool slots of the batch loop
+const size_t BUFFER_DECODED = 0; // Decoded texels used for verification, quality metrics and the PNG
+
+// Command line options
+struct Options {
+    std::string sampleDirectory;
+    std::string outputDirectory;
+    std::string reportPath; // Structured run report (JSON, or CSV for a .csv extension)
+    std::vector<SyntheticPattern> syntheticPatterns; // Generated inputs processed alongside the PNGs
+    std::vector<int> syntheticSizes = {256, 1024};
+    uint64_t seed = 1;
+    std::string tracePath;     // Chrome trace JSON output (requires -DENABLE_TRACING=ON)
+    std::string cacheDirectory; // Content-addressed output cache; empty disables it
+    bool incremental = false;   // Skip inputs unchanged since the last run (per the output directory's manifest)
+    bool perfCounters = false; // Wrap each encode/decode call with hardware performance counters
+    bool dedupe = false;       // Reuse the encoding of identical 4x4 blocks across the whole batch
+    int sequenceMaxError = -1; // Treat the inputs as ordered frames and reuse unchanged blocks; -1 disables
+    bool generateMips = false; // Write the full mip chain, base level first, instead of the base level only
+    MipFilter mipFilter = MipFilter::Kaiser;
+    OutputContainer container = OutputContainer::Raw;
+    std::string archivePath; // Pack every output into this one archive instead of one file per output
+    HugePageMode hugePages = HugePageMode::Off; // Page backing of the pooled decode buffers
+    DecoderProfile decoderProfile = DecoderProfile::D3D10; // Palette rounding the encoders target and verification decodes with
+};
+
+// One texture to process: a PNG file or a generated synthetic texture
+struct InputSource {
+    std::string name;     // Used for output file names
+    std::string filePath; // Empty for synthetic inputs
+    SyntheticPattern pattern = SyntheticPattern::Gradient;
+    int size = 0;
+};
+
+// Helper function to split a comma separated list
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+        if (end > start) items.push_back(list.substr(start, end - start));
+        start = end + 1;
+    }
+    return items;
+}
+
+// Function to parse the command line into options
+bool parseArguments(int argc, char* argv[], Options& options) {
+    if (argc < 3) {
+        return false;
+    }
+
+    options.sampleDirectory = argv[1];
+    options.outputDirectory = argv[2];
+
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--report" && i + 1 < argc) {
+            options.reportPath = argv[++i];
+        } else if (arg == "--synthetic" && i + 1 < argc) {
+            options.syntheticPatterns.clear();
+            for (const std::string& name : splitList(argv[++i])) {
+                SyntheticPattern pattern;
+                if (name == "all") {
+                    options.syntheticPatterns = getSyntheticPatterns();
+                } else if (parseSyntheticPattern(name, pattern)) {
+                    options.syntheticPatterns.push_back(pattern);
+                } else {
+                    std::cerr << "Unknown synthetic pattern: " << name << std::endl;
+                    return false;
+                }
+            }
+        } else if (arg == "--synthetic-sizes" && i + 1 < argc) {
+            options.syntheticSizes.clear();
+            for (const std::string& size : splitList(argv[++i])) {
+                int value = std::atoi(size.c_str());
+                if (value < SYNTHETIC_MIN_SIZE || value > SYNTHETIC_MAX_SIZE) {
+                    std::cerr << "Synthetic size out of range: " << size << std::endl;
+                    return false;
+                }
+                options.syntheticSizes.push_back(value);
+            }
+        } else if (arg == "--trace" && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            LogLevel level;
+            if (!parseLogLevel(argv[++i], level)) {
+                std::cerr << "Unknown log level: " << argv[i] << std::endl;
+                return false;
+            }
+            setLogLevel(level);
+        } else if (arg == "--cache" && i + 1 < argc) {
+            options.cacheDirectory = argv[++i];
+        } else if (arg == "--incremental") {
+            options.incremental = true;
+        } else if (arg == "--perf-counters") {
+            options.perfCounters = true;
+        } else if (arg == "--dedupe") {
+            options.dedupe = true;
+        } else if (arg == "--container" && i + 1 < argc) {
+            std::string container = argv[++i];
+            bool known = false;
+            for (OutputContainer candidate : {OutputContainer::Raw, OutputContainer::DDS, OutputContainer::DDS10, OutputContainer::KTX2, OutputContainer::KTX2LZ}) {
+                if (container == getContainerName(candidate)) {
+                    options.container = candidate;
+                    known = true;
+                }
+            }
+            if (!known) {
+                std::cerr << "Unknown container: " << container << std::endl;
+                return false;
+            }
+        } else if (arg == "--archive" && i + 1 < argc) {
+            options.archivePath = argv[++i];
+        } else if (arg == "--mips" && i + 1 < argc) {
+            if (!parseMipFilter(argv[++i], options.mipFilter)) {
+                std::cerr << "Unknown mip filter: " << argv[i] << std::endl;
+                return false;
+            }
+            options.generateMips = true;
+        } else if (arg == "--sequence" && i + 1 < argc) {
+            options.sequenceMaxError = std::atoi(argv[++i]);
+            if (options.sequenceMaxError < 0 || options.sequenceMaxError > 255) {
+                std::cerr << "Sequence max error out of range (0-255): " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--decoder" && i + 1 < argc) {
+            if (!parseDecoderProfile(argv[++i], options.decoderProfile)) {
+                std::cerr << "Unknown decoder profile: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--huge-pages" && i + 1 < argc) {
+            if (!parseHugePageMode(argv[++i], options.hugePages)) {
+                std::cerr << "Unknown huge page mode: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.generateMips && options.sequenceMaxError >= 0) {
+        std::cerr << "--mips cannot be combined with --sequence" << std::endl;
+        return false;
+    }
+    // The archive index carries the format and dimensions itself, and the cache and manifest track loose files
+    if (!options.archivePath.empty() && (options.container != OutputContainer::Raw || !options.cacheDirectory.empty() || options.incremental)) {
+        std::cerr << "--archive cannot be combined with --container, --cache or --incremental" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to describe the encoder settings that affect the compressed output; part of the cache key
+std::string describeEncoderSettings(const Options& options) {
+    std::string settings;
+    // Exact sequence reuse gives the same bytes as encoding each frame; lossy reuse does not
+    if (options.sequenceMaxError > 0) {
+        settings += "sequence-maxerr=" + std::to_string(options.sequenceMaxError) + ";";
+    }
+    if (options.generateMips) {
+        settings += "mips=" + getMipFilterName(options.mipFilter) + ";";
+    }
+    if (options.container != OutputContainer::Raw) {
+        settings += "container=" + getContainerName(options.container) + ";";
+    }
+    if (options.decoderProfile != DecoderProfile::D3D10) {
+        settings += "decoder=" + getDecoderProfileName(options.decoderProfile) + ";";
+    }
+    return settings.empty() ? "default" : settings;
+}
+
+// Helper function returning seconds elapsed since a steady clock time point
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Function to read PNG file and extract pixel data. The pixels keep the file's channel layout
+// (grey, grey and alpha, RGB or RGBA) rather than being expanded to RGBA, and the buffer takes
+// over stb's allocation instead of copying it.
+ImageBuffer readPNG(const std::string& filePath, int& channels) {
+    TRACE_SCOPE("readPNG");
+    int width, height;
+    unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &channels, 0);
+    if (!data) {
+        LOG_ERROR("Failed to load PNG file: " << filePath);
+        return ImageBuffer();
+    }
+    return ImageBuffer::adopt(data, width, height, static_cast<size_t>(width) * channels, channels, stbi_image_free);
 }
 
 // Function to compress texture using the specified algorithm
-bool compressTexture(const std::vector<uint8_t>& textureData, int width, int height, CompressionAlgorithm algorithm, std::vector<uint8_t>& compressedData) {
+bool compressTexture(const ImageView& image, CompressionAlgorithm algorithm, std::vector<uint8_t>& compressedData) {
+    TRACE_SCOPE("compressTexture");
     switch (algorithm) {
         case CompressionAlgorithm::DXT1:
-            std::cout << "Compressing using DXT1..." << std::endl;
-            compressWithDXT1(textureData, width, height, compressedData);
+            LOG_INFO("Compressing using DXT1...");
+            compressWithDXT1(image, compressedData);
             return true;
         case CompressionAlgorithm::DXT2:
-            std::cout << "Compressing using DXT2..." << std::endl;
-            compressWithDXT2(textureData, width, height, compressedData);
+            LOG_INFO("Compressing using DXT2...");
+            compressWithDXT2(image, compressedData);
             return true;
         // Other cases...
         default:
@@ -56,132 +282,524 @@ bool compressTexture(const std::vector<uint8_t>& textureData, int width, int hei
     }
 }
 
-// Function to uncompress texture using the specified algorithm
-bool decompressTexture(const std::vector<uint8_t>& compressedData, int width, int height, CompressionAlgorithm algorithm, std::vector<uint8_t>& textureData) {
+// Function to uncompress texture using the specified algorithm into width * height * 4 bytes of caller memory
+bool decompressTexture(const std::vector<uint8_t>& compressedData, int width, int height, CompressionAlgorithm algorithm, uint8_t* textureData) {
+    TRACE_SCOPE("decompressTexture");
     switch (algorithm) {
         case CompressionAlgorithm::DXT1:
-            std::cout << "Uncompressing using DXT1..." << std::endl;
-            decompressWithDXT1(compressedData, width, height, textureData);
-            return true;
+            LOG_INFO("Uncompressing using DXT1...");
+            return decompressWithDXT1(compressedData.data(), compressedData.size(), width, height, textureData);
         case CompressionAlgorithm::DXT2:
-            std::cout << "Uncompressing using DXT2..." << std::endl;
-            decompressWithDXT2(compressedData, width, height, textureData);
-            return true;
+            LOG_INFO("Uncompressing using DXT2...");
+            return decompressWithDXT2(compressedData.data(), compressedData.size(), width, height, textureData);
         // Other cases...
         default:
             return false;
     }
 }
 
+// Helper function to delete an existing output before rewriting it. Replacing rather than
+// truncating keeps outputs that are hard links into the output cache from corrupting it.
+void removeExistingFile(const std::string& filePath) {
+    std::error_code error;
+    std::filesystem::remove(filePath, error);
+}
+
 // Function to write compressed data to a file
 void writeToFile(const std::string& filePath, const std::vector<uint8_t>& data) {
+    TRACE_SCOPE("writeToFile");
+    removeExistingFile(filePath);
     std::ofstream outFile(filePath, std::ios::binary);
     if (!outFile) {
-        std::cerr << "Failed to open file for writing: " << filePath << std::endl;
+        LOG_ERROR("Failed to open file for writing: " << filePath);
         return;
     }
     outFile.write(reinterpret_cast<const char*>(data.data()), data.size());
     outFile.close();
 }
 
-// Function to read compressed data from a file
-std::vector<uint8_t> readFromFile(const std::string& filePath) {
-    std::ifstream inFile(filePath, std::ios::binary | std::ios::ate);
-    if (!inFile) {
-        std::cerr << "Failed to open file for reading: " << filePath << std::endl;
-        return {};
+// Function to write compressed data in the selected container. mipLevels levels are stored back to back, base level first.
+bool writeCompressedOutput(const std::string& filePath, OutputContainer container, CompressionAlgorithm algorithm,
+                           int width, int height, int mipLevels, const std::vector<uint8_t>& compressedData) {
+    if (container == OutputContainer::Raw) {
+        writeToFile(filePath, compressedData);
+        return true;
     }
-    std::streamsize size = inFile.tellg();
-    inFile.seekg(0, std::ios::beg);
-    std::vector<uint8_t> buffer(size);
-    if (!inFile.read(reinterpret_cast<char*>(buffer.data()), size)) {
-        std::cerr << "Failed to read file: " << filePath << std::endl;
-        return {};
+    removeExistingFile(filePath);
+    if (container == OutputContainer::KTX2 || container == OutputContainer::KTX2LZ) {
+        KTX2Description description;
+        description.algorithm = algorithm;
+        description.width = width;
+        description.height = height;
+        description.mipLevels = mipLevels;
+        description.supercompressionScheme = container == OutputContainer::KTX2LZ ? KTX2_SUPERCOMPRESSION_LZ_BLOCK : KTX2_SUPERCOMPRESSION_NONE;
+        return writeKTX2(filePath, description, compressedData.data(), compressedData.size());
     }
-    return buffer;
+    DDSDescription description;
+    description.algorithm = algorithm;
+    description.width = width;
+    description.height = height;
+    description.mipLevels = mipLevels;
+    description.dx10Header = container == OutputContainer::DDS10;
+    return writeDDS(filePath, description, compressedData.data(), compressedData.size());
 }
 
-void printStatistics(const std::string& inputFilePath, const std::string& outputFilePath, int width, int height, int channels, const std::vector<uint8_t>& compressedData) {
+// Function to decode the base level straight out of a memory-mapped DDS file, checking its header
+bool decompressDDS(const std::string& filePath, CompressionAlgorithm algorithm, int width, int height, uint8_t* textureData) {
+    TRACE_SCOPE("decompressDDS");
+    DDSFile file;
+    if (!file.open(filePath)) {
+        return false;
+    }
+    const DDSDescription& description = file.description();
+    const BlockCodec* codec = findBlockCodec(description.algorithm);
+    if (description.algorithm != algorithm || description.width != width || description.height != height || !codec) {
+        LOG_ERROR("DDS header does not match the encoded texture: " << filePath);
+        return false;
+    }
+    LOG_INFO("Uncompressing " << getAlgorithmName(algorithm) << " from " << filePath << "...");
+    size_t surfaceBytes = 0;
+    const uint8_t* surface = file.surface(0, 0, surfaceBytes);
+    return decompressImageParallel(*codec, surface, surfaceBytes, width, height, textureData, 1);
+}
+
+// Function to decode the base level of a KTX2 file: straight from the mapping, or expanded first when supercompressed
+bool decompressKTX2(const std::string& filePath, CompressionAlgorithm algorithm, int width, int height, uint8_t* textureData) {
+    TRACE_SCOPE("decompressKTX2");
+    KTX2File file;
+    if (!file.open(filePath)) {
+        return false;
+    }
+    const KTX2Description& description = file.description();
+    const BlockCodec* codec = findBlockCodec(description.algorithm);
+    if (description.algorithm != algorithm || description.width != width || description.height != height || !codec) {
+        LOG_ERROR("KTX2 header does not match the encoded texture: " << filePath);
+        return false;
+    }
+    LOG_INFO("Uncompressing " << getAlgorithmName(algorithm) << " from " << filePath << "...");
+    std::vector<uint8_t> scratch;
+    const uint8_t* level = file.levelData(0, scratch);
+    if (!level) {
+        return false;
+    }
+    return decompressImageParallel(*codec, level, getCompressedSize(*codec, width, height), width, height, textureData, 1);
+}
+
+void printStatistics(const std::string& inputFilePath, const std::string& outputFilePath, int width, int height, int channels) {
     std::ifstream inputFile(inputFilePath, std::ios::binary | std::ios::ate);
     std::ifstream outputFile(outputFilePath, std::ios::binary | std::ios::ate);
 
-    if (!inputFile || !outputFile) {
-        std::cerr << "Failed to open input or output file for statistics." << std::endl;
+    if (!outputFile) {
+        LOG_ERROR("Failed to open output file for statistics.");
         return;
     }
 
-    auto inputFileSize = inputFile.tellg();
+    // Synthetic inputs have no file; compare against their raw RGBA size instead
+    std::streamoff inputFileSize = inputFile ? static_cast<std::streamoff>(inputFile.tellg()) : static_cast<std::streamoff>(width) * height * 4;
     auto outputFileSize = outputFile.tellg();
 
-    std::cout << "Input File: " << inputFilePath << std::endl;
-    std::cout << "Input File Size: " << inputFileSize << " bytes" << std::endl;
-    std::cout << "Image Dimensions: " << width << "x" << height << std::endl;
-    std::cout << "Number of Channels: " << channels << std::endl;
+    LOG_INFO("Input File: " << inputFilePath);
+    LOG_INFO("Input File Size: " << inputFileSize << " bytes");
+    LOG_INFO("Image Dimensions: " << width << "x" << height);
+    LOG_INFO("Number of Channels: " << channels);
+
+    LOG_INFO("Output File: " << outputFilePath);
+    LOG_INFO("Output File Size: " << outputFileSize << " bytes");
+    LOG_INFO("Compression Ratio: " << static_cast<double>(inputFileSize) / outputFileSize);
+}
 
-    std::cout << "Output File: " << outputFilePath << std::endl;
-    std::cout << "Output File Size: " << outputFileSize << " bytes" << std::endl;
-    std::cout << "Compression Ratio: " << static_cast<double>(inputFileSize) / outputFileSize << std::endl;
+void saveAsPNG(const std::string& filePath, const uint8_t* data, int width, int height) {
+    TRACE_SCOPE("saveAsPNG");
+    removeExistingFile(filePath);
+    if (!stbi_write_png(filePath.c_str(), width, height, 4, data, width * 4)) {
+        LOG_ERROR("Failed to write PNG file: " << filePath);
+    }
 }
 
-void saveAsPNG(const std::string& filePath, const std::vector<uint8_t>& data, int width, int height) {
-    if (!stbi_write_png(filePath.c_str(), width, height, 4, data.data(), width * 4)) {
-        std::cerr << "Failed to write PNG file: " << filePath << std::endl;
+// Function to encode an RGBA image as PNG in memory, replacing the contents of png
+bool encodePNG(const uint8_t* data, int width, int height, std::vector<uint8_t>& png) {
+    TRACE_SCOPE("encodePNG");
+    png.clear();
+    auto append = [](void* context, void* bytes, int size) {
+        std::vector<uint8_t>& output = *static_cast<std::vector<uint8_t>*>(context);
+        output.insert(output.end(), static_cast<const uint8_t*>(bytes), static_cast<const uint8_t*>(bytes) + size);
+    };
+    if (!stbi_write_png_to_func(append, &png, width, height, 4, data, width * 4)) {
+        LOG_ERROR("Failed to encode PNG image");
+        return false;
     }
+    return true;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <path/to/sample/directory> <path/to/output/directory>" << std::endl;
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " <path/to/sample/directory|-> <path/to/output/directory> [--report <report.json|report.csv>]"
+                  << " [--synthetic <all|pattern,...>] [--synthetic-sizes 256,1024] [--seed N] [--perf-counters] [--trace <trace.json>] [--cache <directory>] [--incremental] [--dedupe] [--sequence <max-error>] [--mips box|kaiser|lanczos] [--container raw|dds|dds10|ktx2|ktx2-lz]"
+                  << " [--archive <archive.tca>] [--huge-pages off|transparent|explicit] [--decoder legacy|d3d10|nvidia|amd]"
+                  << " [--log-level trace|debug|info|warning|error|off]" << std::endl;
         return 1;
     }
+    setDecoderProfile(options.decoderProfile);
+    LOG_INFO("Kernels: " << getSimdIsaName(getActiveSimdIsa()) << (getDXTKernels().bmi2Packing ? ", BMI2 index packing" : ", portable index packing"));
+
+    const std::string& sampleDirectory = options.sampleDirectory;
+    const std::string& outputDirectory = options.outputDirectory;
+
+    // Collect the inputs: every PNG in the sample directory ("-" for none) plus any synthetic textures
+    std::vector<InputSource> inputs;
+    if (sampleDirectory != "-") {
+        for (const auto& entry : std::filesystem::directory_iterator(sampleDirectory)) {
+            if (entry.path().extension() == ".png") {
+                InputSource input;
+                input.name = entry.path().filename().string();
+                input.filePath = entry.path().string();
+                inputs.push_back(input);
+            }
+        }
+        // Directory order is unspecified; sort so runs are repeatable and sequences see frames in order
+        std::sort(inputs.begin(), inputs.end(), [](const InputSource& a, const InputSource& b) { return a.name < b.name; });
+    }
+    for (SyntheticPattern pattern : options.syntheticPatterns) {
+        for (int size : options.syntheticSizes) {
+            InputSource input;
+            input.name = getSyntheticPatternName(pattern) + "_" + std::to_string(size) + "x" + std::to_string(size) + "_seed" + std::to_string(options.seed);
+            input.pattern = pattern;
+            input.size = size;
+            inputs.push_back(input);
+        }
+    }
+
+    if (!options.tracePath.empty()) {
+        if (!traceCompiledIn()) {
+            LOG_WARNING("Tracing was not compiled in (configure with -DENABLE_TRACING=ON); ignoring --trace.");
+        }
+        traceSetThreadName("main");
+        traceStart();
+    }
+
+    // Hardware counters are optional; without them the report carries timing only
+    std::unique_ptr<PerfCounterGroup> counters;
+    if (options.perfCounters) {
+        counters.reset(new PerfCounterGroup());
+        if (!counters->isAvailable()) {
+            LOG_WARNING("Hardware performance counters unavailable (" << counters->unavailableReason() << "); reporting timing only.");
+            counters.reset();
+        }
+    }
+
+    // Lossy sequence reuse makes each frame depend on the frames before it, which neither the
+    // output cache key nor the incremental manifest can describe
+    if (options.sequenceMaxError > 0 && (!options.cacheDirectory.empty() || options.incremental)) {
+        LOG_WARNING("--sequence with a max error above 0 makes frames depend on earlier frames; ignoring --cache and --incremental.");
+        options.cacheDirectory.clear();
+        options.incremental = false;
+    }
+
+    std::unique_ptr<OutputCache> outputCache;
+    if (!options.cacheDirectory.empty()) {
+        outputCache.reset(new OutputCache(options.cacheDirectory));
+    }
+    const std::string encoderSettings = describeEncoderSettings(options);
+
+    // One table for the whole batch so tiles repeated across textures are encoded once
+    std::unique_ptr<BlockDedupeCache> dedupeCache;
+    if (options.dedupe) {
+        dedupeCache.reset(new BlockDedupeCache());
+    }
+
+    // Sequence mode: one encoder per algorithm, restarted whenever the frame size changes
+    std::map<CompressionAlgorithm, std::unique_ptr<SequenceEncoder>> sequenceEncoders;
+
+    // Incremental mode: the manifest of the previous run lets unchanged inputs skip even the PNG decode
+    RunManifest manifest;
+    const std::string manifestPath = outputDirectory + "/.texture_manifest";
+    const std::string manifestSettings = std::string(TCA_ENCODER_VERSION) + "|" + encoderSettings;
+    bool manifestUsable = false;
+    size_t skippedInputs = 0;
+    if (options.incremental) {
+        manifestUsable = manifest.load(manifestPath) && manifest.settings() == manifestSettings;
+        if (!manifestUsable && !manifest.settings().empty()) {
+            LOG_INFO("Encoder settings changed since the last run; reprocessing every input");
+        }
+        manifest.setSettings(manifestSettings);
+    }
 
-    std::string sampleDirectory = argv[1];
-    std::string outputDirectory = argv[2];
+    // Archive mode: every output is appended to one file, published when the run finishes
+    std::unique_ptr<TextureArchiveWriter> archive;
+    if (!options.archivePath.empty()) {
+        archive.reset(new TextureArchiveWriter());
+        if (!archive->open(options.archivePath)) {
+            logFlush();
+            return 1;
+        }
+    }
 
-    for (const auto& entry : std::filesystem::directory_iterator(sampleDirectory)) {
-        if (entry.path().extension() == ".png") {
-            std::string inputFilePath = entry.path().string();
-            int width, height, channels;
-            std::vector<uint8_t> textureData = readPNG(inputFilePath, width, height, channels);
+    // Working memory of the loop below, kept across algorithms and files: the encoders resize
+    // compressedData within its existing capacity, and decoded texels go to pooled memory that
+    // the decoders overwrite without zero-filling
+    BufferPool bufferPool(options.hugePages);
+    std::vector<uint8_t> compressedData;
+    std::vector<uint8_t> encodedPNG;
+
+    RunReport report;
+    auto runStart = std::chrono::steady_clock::now();
+
+    for (const InputSource& input : inputs) {
+        std::string inputFilePath = input.filePath.empty() ? "synthetic:" + input.name : input.filePath;
+
+        uint64_t inputSize = 0;
+        int64_t inputModifiedTime = 0;
+        bool trackInManifest = options.incremental && !input.filePath.empty() &&
+                               RunManifest::statInput(input.filePath, inputSize, inputModifiedTime);
+        if (trackInManifest && manifestUsable && manifest.isUpToDate(input.filePath, inputSize, inputModifiedTime)) {
+            LOG_INFO("Skipping unchanged input: " << inputFilePath);
+            ++skippedInputs;
+            continue;
+        }
+        ManifestEntry manifestEntry;
+        manifestEntry.inputSize = inputSize;
+        manifestEntry.inputModifiedTime = inputModifiedTime;
 
-            if (textureData.empty()) {
-                std::cerr << "Failed to read texture data from PNG file: " << inputFilePath << std::endl;
-                continue;
+        int channels;
+        ImageBuffer image;
+        if (input.filePath.empty()) {
+            channels = 4;
+            image = ImageBuffer::adopt(generateSyntheticTexture(input.pattern, input.size, input.size, options.seed), input.size, input.size);
+        } else {
+            image = readPNG(inputFilePath, channels);
+        }
+
+        if (image.empty()) {
+            LOG_ERROR("Failed to read texture data from input: " << inputFilePath);
+            continue;
+        }
+        const ImageView textureData = image.view();
+        int width = textureData.width;
+        int height = textureData.height;
+
+        uint64_t pixelHash = outputCache ? OutputCache::hashPixels(textureData) : 0;
+
+        for (int i = static_cast<int>(CompressionAlgorithm::DXT1); i <= static_cast<int>(CompressionAlgorithm::BC7); ++i) {
+            CompressionAlgorithm algorithm = static_cast<CompressionAlgorithm>(i);
+            if (!findBlockCodec(algorithm)) {
+                continue; // Not implemented yet
             }
 
-            for (int i = static_cast<int>(CompressionAlgorithm::DXT1); i <= static_cast<int>(CompressionAlgorithm::BC7); ++i) {
-                CompressionAlgorithm algorithm = static_cast<CompressionAlgorithm>(i);
-                std::vector<uint8_t> compressedData;
-                if (compressTexture(textureData, width, height, algorithm, compressedData)) {
-                    std::string algorithmName;
-                    switch (algorithm) {
-                        case CompressionAlgorithm::DXT1:
-                            algorithmName = "DXT1";
-                            break;
-                        case CompressionAlgorithm::DXT2:
-                            algorithmName = "DXT2";
-                            break;
-                        // Add other cases as needed
-                        default:
-                            algorithmName = "Unknown";
-                            break;
+            RunReportRow row;
+            row.inputFile = inputFilePath;
+            row.algorithm = getAlgorithmName(algorithm);
+            row.width = width;
+            row.height = height;
+            row.channels = channels;
+
+            std::string algorithmName = row.algorithm;
+            std::string outputFilePath = outputDirectory + "/" + input.name + "." + algorithmName + getContainerExtension(options.container);
+            std::string uncompressedFilePath = outputDirectory + "/" + input.name + "." + algorithmName + ".uncompressed.png";
+
+            // Unchanged pixels with unchanged settings: reuse the stored outputs
+            uint64_t cacheKey = 0;
+            if (outputCache) {
+                cacheKey = OutputCache::computeKey(pixelHash, width, height, algorithm, encoderSettings);
+                OutputCacheEntryInfo cached;
+                if (outputCache->restore(cacheKey, outputFilePath, uncompressedFilePath, cached)) {
+                    row.cacheHit = true;
+                    row.compressedBytes = cached.compressedBytes;
+                    row.mipLevels = cached.mipLevels;
+                    LOG_INFO("Restored " << algorithmName << " output from cache");
+                    printStatistics(inputFilePath, outputFilePath, width, height, channels);
+                    report.addRow(row);
+                    if (trackInManifest) {
+                        manifestEntry.outputs.push_back(RunManifest::describeOutput(outputFilePath));
+                        manifestEntry.outputs.push_back(RunManifest::describeOutput(uncompressedFilePath));
                     }
-                    std::string outputFilePath = outputDirectory + "/" + entry.path().filename().string() + "." + algorithmName + ".compressed";
-                    writeToFile(outputFilePath, compressedData);
-                    printStatistics(inputFilePath, outputFilePath, width, height, channels, compressedData);
+                    continue;
+                }
+            }
 
-                    // Uncompress the data to verify correctness
-                    std::vector<uint8_t> uncompressedData;
-                    if (decompressTexture(compressedData, width, height, algorithm, uncompressedData)) {
-                        std::string uncompressedFilePath = outputDirectory + "/" + entry.path().filename().string() + "." + algorithmName + ".uncompressed.png";
+            if (counters) counters->start();
+            auto encodeStart = std::chrono::steady_clock::now();
+            bool compressed;
+            if (options.sequenceMaxError >= 0) {
+                std::unique_ptr<SequenceEncoder>& sequenceEncoder = sequenceEncoders[algorithm];
+                if (!sequenceEncoder || sequenceEncoder->width() != width || sequenceEncoder->height() != height) {
+                    sequenceEncoder.reset(new SequenceEncoder(*findBlockCodec(algorithm), width, height, options.sequenceMaxError));
+                }
+                LOG_INFO("Compressing using " << algorithmName << " as a sequence frame...");
+                BlockDedupeStats dedupeBefore = dedupeCache ? dedupeCache->stats() : BlockDedupeStats();
+                SequenceFrameStats frameStats = sequenceEncoder->encodeFrame(textureData, compressedData, dedupeCache.get());
+                if (dedupeCache) {
+                    row.dedupeLookups = dedupeCache->stats().lookups - dedupeBefore.lookups;
+                    row.dedupeHits = dedupeCache->stats().hits - dedupeBefore.hits;
+                }
+                row.sequenceFrame = true;
+                row.sequenceReusedExact = frameStats.reusedExact;
+                row.sequenceReusedWithinError = frameStats.reusedWithinError;
+                row.sequenceEncodedBlocks = frameStats.encoded;
+                compressed = true;
+            } else if (options.generateMips) {
+                LOG_INFO("Compressing using " << algorithmName << " with a " << getMipFilterName(options.mipFilter) << " mip chain...");
+                BlockDedupeStats dedupeBefore = dedupeCache ? dedupeCache->stats() : BlockDedupeStats();
+                compressedData.clear();
+                std::vector<CompressedMipLevel> levels = compressMipChain(*findBlockCodec(algorithm), textureData, options.mipFilter, 0,
+                                                                          dedupeCache.get());
+                for (const CompressedMipLevel& level : levels) {
+                    compressedData.insert(compressedData.end(), level.compressedData.begin(), level.compressedData.end());
+                }
+                if (dedupeCache) {
+                    row.dedupeLookups = dedupeCache->stats().lookups - dedupeBefore.lookups;
+                    row.dedupeHits = dedupeCache->stats().hits - dedupeBefore.hits;
+                }
+                row.mipLevels = static_cast<int>(levels.size());
+                compressed = true;
+            } else if (dedupeCache) {
+                LOG_INFO("Compressing using " << algorithmName << " with block dedupe...");
+                BlockDedupeStats dedupeStats = compressImageDeduplicated(*findBlockCodec(algorithm), textureData, compressedData, *dedupeCache);
+                row.dedupeLookups = dedupeStats.lookups;
+                row.dedupeHits = dedupeStats.hits;
+                compressed = true;
+            } else {
+                compressed = compressTexture(textureData, algorithm, compressedData);
+            }
+            double encodeSeconds = secondsSince(encodeStart);
+            PerfCounterSample encodeCounters = counters ? counters->stop() : PerfCounterSample();
+            if (compressed) {
+                row.encodeSeconds = encodeSeconds;
+                row.encodeCounters = encodeCounters;
+                row.compressedBytes = compressedData.size();
 
-                        // Save the uncompressed data as a PNG file
+                if (archive) {
+                    ArchiveEntryInfo info;
+                    info.algorithm = algorithm;
+                    info.width = width;
+                    info.height = height;
+                    info.mipLevels = row.mipLevels;
+                    if (!archive->add(input.name + "." + algorithmName + ".compressed", info, compressedData.data(), compressedData.size())) {
+                        continue;
+                    }
+                    LOG_INFO("Archived " << algorithmName << " output of " << inputFilePath << " (" << compressedData.size() << " bytes)");
+                } else {
+                    if (!writeCompressedOutput(outputFilePath, options.container, algorithm, width, height, row.mipLevels, compressedData)) {
+                        continue;
+                    }
+                    printStatistics(inputFilePath, outputFilePath, width, height, channels);
+                }
+                if (row.sequenceFrame) {
+                    LOG_INFO("Sequence: " << row.sequenceReusedExact << " blocks unchanged, " << row.sequenceReusedWithinError
+                             << " within error, " << row.sequenceEncodedBlocks << " encoded");
+                }
+                if (dedupeCache) {
+                    LOG_INFO("Block dedupe: " << row.dedupeHits << " of " << row.dedupeLookups << " blocks reused ("
+                             << row.dedupeHitRate() * 100.0 << "%)");
+                }
+
+                // Uncompress the data to verify correctness (the base level of a mip chain)
+                uint8_t* uncompressedData = bufferPool.acquire(BUFFER_DECODED, static_cast<size_t>(width) * height * 4);
+                if (counters) counters->start();
+                auto decodeStart = std::chrono::steady_clock::now();
+                bool decompressed;
+                if (options.container == OutputContainer::KTX2 || options.container == OutputContainer::KTX2LZ) {
+                    decompressed = decompressKTX2(outputFilePath, algorithm, width, height, uncompressedData);
+                } else if (options.container != OutputContainer::Raw) {
+                    decompressed = decompressDDS(outputFilePath, algorithm, width, height, uncompressedData);
+                } else {
+                    decompressed = decompressTexture(compressedData, width, height, algorithm, uncompressedData);
+                }
+                double decodeSeconds = secondsSince(decodeStart);
+                PerfCounterSample decodeCounters = counters ? counters->stop() : PerfCounterSample();
+                if (decompressed) {
+                    row.decodeSeconds = decodeSeconds;
+                    row.decodeCounters = decodeCounters;
+                    row.decoded = true;
+                    row.quality = computeQualityMetrics(textureData, uncompressedData);
+
+                    // Save the uncompressed data as a PNG file
+                    if (archive) {
+                        ArchiveEntryInfo info;
+                        info.kind = ArchiveEntryKind::PNG;
+                        info.algorithm = algorithm;
+                        info.width = width;
+                        info.height = height;
+                        if (encodePNG(uncompressedData, width, height, encodedPNG)) {
+                            archive->add(input.name + "." + algorithmName + ".uncompressed.png", info, encodedPNG.data(), encodedPNG.size());
+                        }
+                    } else {
                         saveAsPNG(uncompressedFilePath, uncompressedData, width, height);
                     }
+
+                    if (outputCache) {
+                        OutputCacheEntryInfo stored;
+                        stored.compressedBytes = row.compressedBytes;
+                        stored.mipLevels = row.mipLevels;
+                        outputCache->store(cacheKey, outputFilePath, uncompressedFilePath, stored);
+                    }
+                    if (trackInManifest) {
+                        manifestEntry.outputs.push_back(RunManifest::describeOutput(uncompressedFilePath));
+                    }
                 }
+                if (trackInManifest) {
+                    manifestEntry.outputs.push_back(RunManifest::describeOutput(outputFilePath));
+                }
+
+                report.addRow(row);
             }
         }
+
+        if (trackInManifest) {
+            manifest.set(input.filePath, manifestEntry);
+        }
+    }
+
+    if (options.incremental) {
+        size_t removedOutputs = manifest.removeOutputsOfMissingInputs();
+        manifest.save(manifestPath);
+        LOG_INFO("Incremental: " << skippedInputs << " unchanged inputs skipped, " << removedOutputs << " stale outputs removed");
+        report.addSummaryCounter("incrementalSkippedInputs", skippedInputs);
+        report.addSummaryCounter("incrementalRemovedOutputs", removedOutputs);
+    }
+
+    if (archive) {
+        size_t archiveEntries = archive->entryCount();
+        if (!archive->finish()) {
+            logFlush();
+            return 1;
+        }
+        LOG_INFO("Archive: " << archiveEntries << " entries, " << archive->bytesWritten() << " bytes written to " << options.archivePath);
+        report.addSummaryCounter("archiveEntries", archiveEntries);
+        report.addSummaryCounter("archiveBytes", archive->bytesWritten());
+    }
+
+    report.setTotalSeconds(secondsSince(runStart));
+    if (outputCache) {
+        const OutputCacheStats& cacheStats = outputCache->stats();
+        LOG_INFO("Output cache: " << cacheStats.hits << " hits, " << cacheStats.misses << " misses, " << cacheStats.stores << " stores, "
+                 << cacheStats.linkedFiles << " files linked, " << cacheStats.copiedFiles << " copied, " << cacheStats.bytesRestored << " bytes restored");
+        report.addSummaryCounter("cacheHits", cacheStats.hits);
+        report.addSummaryCounter("cacheMisses", cacheStats.misses);
+        report.addSummaryCounter("cacheStores", cacheStats.stores);
+        report.addSummaryCounter("cacheBytesRestored", cacheStats.bytesRestored);
+    }
+    if (dedupeCache) {
+        const BlockDedupeStats& dedupeStats = dedupeCache->stats();
+        LOG_INFO("Block dedupe: " << dedupeStats.hits << " of " << dedupeStats.lookups << " blocks reused across the batch ("
+                 << dedupeStats.hitRate() * 100.0 << "%)");
+        report.addSummaryCounter("dedupeLookups", dedupeStats.lookups);
+        report.addSummaryCounter("dedupeHits", dedupeStats.hits);
+    }
+    const BufferPoolStats& poolStats = bufferPool.stats();
+    LOG_INFO("Buffer pool: " << poolStats.allocations << " allocations for " << poolStats.requests << " requests, "
+             << poolStats.bytesReserved << " bytes reserved, " << poolStats.hugePageBytes << " on huge pages");
+    report.addSummaryCounter("bufferPoolAllocations", poolStats.allocations);
+    report.addSummaryCounter("bufferPoolBytes", poolStats.bytesReserved);
+    report.addSummaryCounter("bufferPoolHugePageBytes", poolStats.hugePageBytes);
+    if (!options.tracePath.empty() && traceCompiledIn()) {
+        traceWriteChromeJSON(options.tracePath);
+    }
+    if (!options.reportPath.empty() && !report.write(options.reportPath)) {
+        logFlush();
+        return 1;
     }
 
+    logFlush();
     return 0;
-}
\ No newline at end of file
+}
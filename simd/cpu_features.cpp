@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <cstring>
+#include "../include/simd/cpu_features.h"
+
+#if defined(TCA_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(TCA_X86)
+#include <cpuid.h>
+#endif
+
+#ifdef TCA_X86
+// Helper function to run cpuid for a leaf and subleaf
+static void queryCpuid(unsigned leaf, unsigned subleaf, unsigned registers[4]) {
+#ifdef _MSC_VER
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        registers[i] = static_cast<unsigned>(values[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+// Helper function to read the register state the OS saves on context switches (XCR0)
+static uint64_t queryEnabledStates() {
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    unsigned low, high;
+    __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (static_cast<uint64_t>(high) << 32) | low;
+#endif
+}
+
+// Function to detect the features with cpuid
+static CpuFeatures detectCpuFeatures() {
+    CpuFeatures features;
+    unsigned registers[4] = {};
+    queryCpuid(0, 0, registers);
+    unsigned maxLeaf = registers[0];
+    char vendor[13] = {};
+    std::memcpy(vendor, &registers[1], 4);
+    std::memcpy(vendor + 4, &registers[3], 4);
+    std::memcpy(vendor + 8, &registers[2], 4);
+    if (maxLeaf < 7) {
+        return features;
+    }
+
+    queryCpuid(1, 0, registers);
+    unsigned family = (registers[0] >> 8) & 0x0F;
+    if (family == 0x0F) {
+        family += (registers[0] >> 20) & 0xFF;
+    }
+    // Vector registers are only usable if the OS saves them: XMM and YMM state (bits 1-2), plus
+    // the opmask and both halves of the ZMM state (bits 5-7) for AVX-512
+    uint64_t enabledStates = (registers[2] & (1u << 27)) != 0 ? queryEnabledStates() : 0;
+    bool ymmEnabled = (enabledStates & 0x06) == 0x06;
+    bool zmmEnabled = ymmEnabled && (enabledStates & 0xE0) == 0xE0;
+
+    queryCpuid(7, 0, registers);
+    features.bmi2 = (registers[1] & (1u << 8)) != 0;
+    // Zen 1 and 2 (family 17h) and earlier AMD cores implement pdep/pext in microcode
+    features.fastPdep = features.bmi2 && !(std::strcmp(vendor, "AuthenticAMD") == 0 && family < 0x19);
+    features.avx2 = ymmEnabled && (registers[1] & (1u << 5)) != 0;
+    // F (bit 16), BW (bit 30) and VL (bit 31)
+    features.avx512 = zmmEnabled && (registers[1] & 0xC0010000u) == 0xC0010000u;
+    return features;
+}
+#else
+static CpuFeatures detectCpuFeatures() {
+    return CpuFeatures();
+}
+#endif
+
+const CpuFeatures& getCpuFeatures() {
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
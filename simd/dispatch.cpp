@@ -0,0 +1,74 @@
+#include <cstdlib>
+#include "../include/simd/dispatch.h"
+#include "../include/simd/cpu_features.h"
+#include "../include/logging/logger.h"
+
+std::string getSimdIsaName(SimdIsa isa) {
+    switch (isa) {
+        case SimdIsa::Scalar: return "scalar";
+        case SimdIsa::Generic: return "generic";
+        case SimdIsa::AVX2: return "avx2";
+        case SimdIsa::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+bool parseSimdIsa(const std::string& name, SimdIsa& isa) {
+    for (SimdIsa candidate : {SimdIsa::Scalar, SimdIsa::Generic, SimdIsa::AVX2, SimdIsa::AVX512}) {
+        if (name == getSimdIsaName(candidate)) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isSimdIsaSupported(SimdIsa isa) {
+    const CpuFeatures& features = getCpuFeatures();
+    switch (isa) {
+        case SimdIsa::Scalar:
+        case SimdIsa::Generic:
+            return true;
+#ifdef TCA_SIMD_X86_TARGETS
+        // Their translation units are compiled with -mbmi2, which every AVX2 CPU has; whether
+        // pdep/pext are fast enough for the index packing is decided inside the kernel table
+        case SimdIsa::AVX2:
+            return features.avx2 && features.bmi2;
+        case SimdIsa::AVX512:
+            return features.avx512 && features.bmi2;
+#endif
+        default:
+            (void)features;
+            return false;
+    }
+}
+
+// Helper function to choose the instruction set on first use
+static SimdIsa chooseSimdIsa() {
+    SimdIsa best = SimdIsa::Generic;
+    for (SimdIsa candidate : {SimdIsa::AVX2, SimdIsa::AVX512}) {
+        if (isSimdIsaSupported(candidate)) {
+            best = candidate;
+        }
+    }
+
+    const char* forced = std::getenv("TCA_FORCE_ISA");
+    if (forced == nullptr || *forced == '\0') {
+        return best;
+    }
+    SimdIsa isa;
+    if (!parseSimdIsa(forced, isa)) {
+        LOG_WARNING("Unknown TCA_FORCE_ISA value " << forced << "; using " << getSimdIsaName(best));
+        return best;
+    }
+    if (!isSimdIsaSupported(isa)) {
+        LOG_WARNING("TCA_FORCE_ISA=" << forced << " is not supported by this build or CPU; using " << getSimdIsaName(best));
+        return best;
+    }
+    return isa;
+}
+
+SimdIsa getActiveSimdIsa() {
+    static const SimdIsa isa = chooseSimdIsa();
+    return isa;
+}